@@ -50,6 +50,19 @@ typedef void (*bsp_gp22callback_t)(void);
 #define BSP_GP22_RESONATOR_CYCLE	2.0		/*!< Number of cycles while resonator calibration. */
 #define BSP_GP22_HS_CRYSTAL	4000000.0		/*!< Frequency of the high speed crystal [Hz]. */
 
+/*
+ * The temperature measurement needs a PT1000 sensor at port PT1, a 1 kOhm
+ * reference resistor at port PT2 and the load capacitor at LOAD_T of the
+ * GP22. The scanner board does not have them fitted by default, so it is
+ * disabled. Without it, the temperature stays 0 and no correction is applied.
+ */
+#define BSP_GP22_TEMP			0				/*!< Set to 1 to measure the temperature each turn. */
+#define BSP_GP22_TEMP_SENSOR	GP22_RD_RES_0	/*!< Result register with the discharge time of the temperature sensor (port PT1). */
+#define BSP_GP22_TEMP_REF		GP22_RD_RES_1	/*!< Result register with the discharge time of the reference resistor (port PT2). */
+#define BSP_GP22_TEMP_RREF		1000.0			/*!< Reference resistor of the temperature measurement [Ohm]. */
+#define BSP_GP22_TEMP_R0		1000.0			/*!< Resistance of the PT1000 sensor at 0 degree Celsius [Ohm]. */
+#define BSP_GP22_TEMP_ALPHA		0.00385			/*!< Temperature coefficient of the PT1000 sensor [1/K]. */
+
 /*
  * ----------------------------------------------------------------------------
  * Hardware configurations
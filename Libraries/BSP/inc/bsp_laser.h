@@ -95,6 +95,7 @@ static const bsp_gpioconf_t BSP_LASER_PORT = {
 extern void bsp_LaserInit(void);
 extern void bsp_LaserSequenceCalback(bsp_lasercallback_t callback);
 extern void bsp_LaserPulse(uint32_t nr_of_pulses);
+extern void bsp_LaserPeriod(uint16_t period);
 extern uint8_t bsp_LaserOvercurrent(void);
 
 
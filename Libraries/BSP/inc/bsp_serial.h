@@ -71,6 +71,7 @@ static const bsp_gpioconf_t BSP_SERIAL_TX = {
  */
 extern void bsp_SerialInit(void);
 extern uint8_t bsp_SerialCharPut(char a);
+extern uint32_t bsp_SerialTxFree(void);
 extern uint8_t bsp_SerialCharGet(char *a);
 extern uint32_t bsp_SerialStringPut(char *string, uint32_t length);
 
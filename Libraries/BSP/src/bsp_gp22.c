@@ -194,7 +194,7 @@ uint8_t bsp_GP22RegRead(uint8_t reg, uint32_t *value, uint8_t len) {
 	uint8_t rx_bytes[5];
 
 	assert(GP22_IS_RD(reg));
-	assert(len==2 || len==4);
+	assert(len==1 || len==2 || len==4);
 
 	/* First send a read command */
 	tx_bytes[0] = reg;
@@ -202,7 +202,10 @@ uint8_t bsp_GP22RegRead(uint8_t reg, uint32_t *value, uint8_t len) {
 
 	/* Transform received bytes to a 32 bit integer */
 	if (success) {
-		if (len == 2) {
+		if (len == 1) {
+			*value = rx_bytes[1];
+		}
+		else if (len == 2) {
 			*value = bytes2short(&(rx_bytes[1]));
 		}
 		else if (len == 4) {
@@ -230,6 +230,42 @@ void bsp_LaserPulse(uint32_t nr_of_pulses) {
 	bsp_LaserEnable();
 }
 
+/**
+ * \brief	Changes the repetition frequency of the laser pulses. The pulse width
+ * 			is kept. It must not be called while a sequence is running.
+ * \param[in]	period is the new period register of the PWM, like BSP_LASER_PERIOD.
+ */
+void bsp_LaserPeriod(uint16_t period) {
+	/* parameter check */
+	assert(period > BSP_LASER_PULSE_WIDTH);
+
+	/* Sets the period register */
+	TIM_SetAutoreload(BSP_LASER_TIMER_PORT_BASE, period);
+
+	/* Keep the pulse at the end of the period */
+	switch (BSP_LASER_TIMER_PORT_CHANEL) {
+	case CHANNEL1:
+		TIM_SetCompare1(BSP_LASER_TIMER_PORT_BASE, period - BSP_LASER_PULSE_WIDTH);
+		break;
+
+	case CHANNEL2:
+		TIM_SetCompare2(BSP_LASER_TIMER_PORT_BASE, period - BSP_LASER_PULSE_WIDTH);
+		break;
+
+	case CHANNEL3:
+		TIM_SetCompare3(BSP_LASER_TIMER_PORT_BASE, period - BSP_LASER_PULSE_WIDTH);
+		break;
+
+	case CHANNEL4:
+		TIM_SetCompare4(BSP_LASER_TIMER_PORT_BASE, period - BSP_LASER_PULSE_WIDTH);
+		break;
+
+	default:
+		assert(BSP_LASER_TIMER_PORT_CHANEL);
+		break;
+	}
+}
+
 /**
  * \brief	Enable the laser pulse generator and send a sequence.
  */
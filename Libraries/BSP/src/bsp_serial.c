@@ -217,6 +217,14 @@ uint8_t bsp_SerialCharPut(char a) {
 	return success;
 }
 
+/**
+ * \brief	Free space of the TX circular buffer.
+ * \return	Number of characters, which can be put without waiting.
+ */
+uint32_t bsp_SerialTxFree(void) {
+	return (TX_BUFFER_LEN - 2) - (g_CircularBuffer.tx_write - g_CircularBuffer.tx_read);
+}
+
 /**
  * \brief	Reads a character from the circular buffer and gives it to the user.
  * \param[out]	a Reference to the character storage.
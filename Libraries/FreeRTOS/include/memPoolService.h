@@ -139,6 +139,10 @@ extern enumMemError  eMemGiveBlockFromISR(MemPoolManager *psMemPoolManager,
                                           void           *pvMemBlock,
                                           portBASE_TYPE  *ps32TaskWoken);
 
+extern unsigned portLONG u32MemGetNumberOfBlocks(MemPoolManager *psMemPoolManager);
+
+extern unsigned portLONG u32MemGetNumberOfFreeBlocks(MemPoolManager *psMemPoolManager);
+
 //----- Data -------------------------------------------------------------------
 
 #endif /* MEMPOOLSERVICE_H_ */
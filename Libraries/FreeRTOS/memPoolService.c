@@ -540,4 +540,43 @@ enumMemError eMemGiveBlockFromISR(MemPoolManager *psMemPoolManager,
     return (eReturnValue);
 }
 
+/*******************************************************************************
+ *  function :    u32MemGetNumberOfBlocks
+ ******************************************************************************/
+/** \brief        Gets the number of memory blocks of a previously created
+ *                memory pool.
+ *
+ *  \type         global
+ *
+ *  \param[in]	  psMemPoolManager     Structure used for managing the
+ *                                     memory pool
+ *
+ *  \return       Number of memory blocks
+ *
+ ******************************************************************************/
+unsigned portLONG u32MemGetNumberOfBlocks(MemPoolManager *psMemPoolManager) {
+
+    return (psMemPoolManager->u32MemNumberOfBlocks);
+}
+
+/*******************************************************************************
+ *  function :    u32MemGetNumberOfFreeBlocks
+ ******************************************************************************/
+/** \brief        Gets the number of free memory blocks of a previously created
+ *                memory pool. It is a snapshot, which can be called out of a
+ *                task or an ISR
+ *
+ *  \type         global
+ *
+ *  \param[in]	  psMemPoolManager     Structure used for managing the
+ *                                     memory pool
+ *
+ *  \return       Number of free memory blocks
+ *
+ ******************************************************************************/
+unsigned portLONG u32MemGetNumberOfFreeBlocks(MemPoolManager *psMemPoolManager) {
+
+    return (psMemPoolManager->u32MemNumberOfFreeBlocks);
+}
+
 
@@ -25,7 +25,7 @@
  */
 #define TASK_CONTROLLER_NAME		"Controller"				/*!< Task name. */
 #define TASK_CONTROLLER_PRIORITY	6							/*!< Task Priority. */
-#define TASK_CONTROLLER_STACKSIZE	configMINIMAL_STACK_SIZE	/*!< Task Stack size. */
+#define TASK_CONTROLLER_STACKSIZE	(configMINIMAL_STACK_SIZE * 2)	/*!< Task Stack size. */
 
 
 /*
@@ -50,6 +50,41 @@
 #define DA_AZIMUTH_CAL_RES			(DA_AZIMUTH_MAX + 2 * 18)	/*!< Azimuth at which the high speed clock is calibrated. */
 
 #define DA_DEF_SCANRATE				1		/*!< Default scan rate in scans per seconds. */
+#define DA_DEF_LASERPULSE			30		/*!< Default laser pulses each point with the default scan rate. */
+#define DA_LASERPULSE_MAX			50		/*!< Maximum laser pulses each point. Must not exceed MAX_RAWDATA_LENGTH. */
+#define DA_SECTOR_MAX				4		/*!< Number of scan sectors each turn, sector 0 is the main scan area. */
+#define DA_ARC_MAX					1000	/*!< Maximum target arc length of the range adaptive sampling [mm]. */
+#define DA_PROFILE_MAX				2		/*!< Number of scan profiles, which can alternate each turn. */
+#define DA_BINNING_MAX				8		/*!< Maximum number of adjacent points pooled into one point. */
+#define DP_WALK_MAX					200		/*!< Maximum walk error correction of a point without intensity [mm]. */
+#define DA_CALIB_MAX				100		/*!< Maximum number of turns between two calibrations. */
+#define DP_TCOMP_POINTS				9		/*!< Number of points of the temperature correction table. */
+#define DP_TCOMP_MIN				-20		/*!< Temperature of the first point of the correction table [degree Celsius]. */
+#define DP_TCOMP_STEP				10		/*!< Temperature step between two points of the correction table [degree Celsius]. */
+#define DP_TCOMP_MAX				100		/*!< Maximum distance correction of the table [mm]. */
+#define DP_FILTER_SHIFT_MAX			4		/*!< Maximum weight shift of the temporal filter. */
+#define DP_FILTER_JUMP_DEF			100		/*!< Default distance change, which resets the temporal filter [mm]. */
+#define DP_MOUNT_MAX				2000	/*!< Maximum mounting offset of the sensor in the vehicle frame [mm]. */
+#define DP_ZONE_MAX					4		/*!< Number of protective zones. */
+#define DP_BACKGROUND_OFF			0		/*!< All points are sent. */
+#define DP_BACKGROUND_POINTS		1		/*!< Only the foreground points are sent. */
+#define DP_BACKGROUND_BLOBS			2		/*!< Only the clustered foreground points are sent. */
+#define DP_BACKGROUND_TURNS_DEF		10		/*!< Default number of turns to learn the background. */
+#define DP_BACKGROUND_TURNS_MAX		100		/*!< Maximum number of turns to learn the background. */
+#define DP_BACKGROUND_TOLERANCE_DEF	50		/*!< Default distance of a foreground point to the background [mm]. */
+#define DP_BACKGROUND_TOLERANCE_MAX	500		/*!< Maximum distance of a foreground point to the background [mm]. */
+#define DP_LINES_OFF				0		/*!< No line segments. */
+#define DP_LINES_ALONGSIDE			1		/*!< Line segments alongside the points. */
+#define DP_LINES_ONLY				2		/*!< Line segments instead of the points. */
+#define DP_LINES_TOLERANCE_DEF		30		/*!< Default maximum distance of a point to its line segment [mm]. */
+#define DP_LINES_TOLERANCE_MAX		500		/*!< Maximum distance of a point to its line segment [mm]. */
+#define DP_LINES_POINTS_DEF			6		/*!< Default fewest points of a line segment. */
+#define DP_LINES_POINTS_MIN			3		/*!< Fewest points of a line segment. */
+#define DP_LINES_POINTS_MAX			100		/*!< Maximum configurable fewest points of a line segment. */
+#define DP_TRACKER_GATE_MAX			2000	/*!< Maximum association gate of the object tracker [mm]. */
+#define DP_TRACKER_MISSES_DEF		3		/*!< Default scans a track is predicted without an object. */
+#define DP_TRACKER_MISSES_MAX		20		/*!< Maximum scans a track is predicted without an object. */
+#define DP_CAPTURE_SCANS_MAX		64		/*!< Maximum scans of a burst capture. */
 
 #define LED_MALFUNCTION				BSP_LED_RED		/*!< LED indicates a malfunction. */
 #define LED_LASER_OPERATION			BSP_LED_BLUE	/*!< LED indicates the laser is operating. */
@@ -72,22 +107,54 @@ typedef struct {
 		Sys_Init = 0,		/*!< Initialize the system. Called after the system start. */
 		Sys_Check,			/*!< Make a system check. */
 		Sys_Welcome,		/*!< Sends the welcome text over the interface. */
+		Sys_CaptureDone,	/*!< The burst capture is complete. */
+		Sys_ScanUpdate,		/*!< A scan configuration of the data mode is taken over. */
 
 		/* User commands */
 		UC_Cmd,				/*!< Change into the command mode. */
 		UC_Data,			/*!< Change into the data mode and starts the data acquisition. */
 		UC_Reboot,			/*!< Reboot the system. */
+		UC_Capture,			/*!< Starts the data acquisition and captures the scans into the RAM. */
 		UC_SetCommEcho,		/*!< Enable/disable the command echo. */
 		UC_SetCommRespmsg,	/*!< Enable/disable the response message. */
+		UC_SetCommIntensity,/*!< Enable/disable the intensity of each point in the data stream. */
+		UC_SetCommFrame,	/*!< Enable/disable the frame of each scan in the data stream. */
+		UC_SetCommDelta,	/*!< Configure the delta encoding of the frames. */
+		UC_SetCommCartesian,/*!< Enable/disable the Cartesian coordinates in the data stream. */
+		UC_SetCommLines,	/*!< Configure the line segments in the data stream. */
+		UC_SetCommBackground,/*!< Configure the background change detection. */
+		UC_SetCommTracker,	/*!< Configure the object tracker in the data stream. */
+		UC_SetCommRaw,		/*!< Enable/disable the raw TDC data instead of the points in the data stream. */
+		UC_SetCommQos,		/*!< Enable/disable the governor of the data stream. */
+		UC_SetCommMarker,	/*!< Enable/disable the scan start marker in the data stream. */
 		UC_SetScanBndry,	/*!< Configure the scan area boundary. */
 		UC_SetScanStep,		/*!< Configure the step size between two measurement points. */
 		UC_SetScanRate,		/*!< Configure the update rate of the hole room map. */
+		UC_SetScanPulses,	/*!< Configure the number of laser pulses each measurement point. */
+		UC_SetScanSector,	/*!< Configure an additional scan sector. */
+		UC_SetScanArc,		/*!< Configure the target arc length of the range adaptive sampling. */
+		UC_SetScanProfile,	/*!< Select the scan profile to configure and to use. */
+		UC_SetScanAlternate,/*!< Enable/disable the alternating scan profiles. */
+		UC_SetScanBinning,	/*!< Configure the number of points pooled into one point. */
+		UC_SetScanGate,		/*!< Configure the range gate of the hits. */
+		UC_SetScanWalk,		/*!< Configure the walk error correction. */
+		UC_SetScanCalib,	/*!< Configure the number of turns between two calibrations. */
+		UC_SetScanTcomp,	/*!< Configure a point of the temperature correction table. */
+		UC_SetScanFilter,	/*!< Configure the temporal filter. */
+		UC_SetScanSpatial,	/*!< Configure the spatial filter. */
+		UC_SetScanMount,	/*!< Configure the mounting position of the sensor. */
+		UC_SetScanZone,		/*!< Configure a protective zone. */
 		UC_SetEngineSleep,	/*!< Sets the time delay before the engine is suspended. */
+		UC_SetEngineStandby,/*!< Enable/disable the engine standby in the command mode. */
+		UC_SetEngineIdle,	/*!< Sets the engine standby speed in the command mode. */
+		UC_SetEngineIlc,	/*!< Enable/disable the speed ripple feed-forward. */
 		UC_GetAll,			/*!< Get all configured parameters. */
 		UC_GetVer,			/*!< Get the version number. */
 		UC_GetComm,			/*!< Get the communication configurations. */
 		UC_GetScan,			/*!< Get the scan configurations. */
 		UC_GetEngine,		/*!< Get the engine configurations. */
+		UC_GetStat,			/*!< Get the runtime statistics. */
+		UC_GetCapture,		/*!< Sends the captured scans. */
 		UC_EE,				/*!< Some magic feature. */
 
 		/* User Command Error */
@@ -117,13 +184,84 @@ typedef struct {
 		/* User command parameters */
 		uint8_t echo;		/*!< Enable or disable the RS232 echo. */
 		uint8_t respmsg;	/*!< Enable or disable the response message. */
+		uint8_t intensity;	/*!< Enable or disable the intensity in the data stream. */
+		uint8_t frame;		/*!< Enable or disable the frames in the data stream. */
+		uint8_t capture;	/*!< Number of scans of the burst capture. */
+		uint8_t scan_id;	/*!< Number of the first turn with the new scan configuration. */
+		uint8_t raw;		/*!< Enable or disable the raw TDC data in the data stream. */
+		uint8_t qos;		/*!< Enable or disable the governor of the data stream. */
+		uint8_t marker;		/*!< Enable or disable the scan start marker in the data stream. */
+		struct {
+			uint8_t keyframe;	/*!< Frames between two keyframes, 0 if disabled. */
+			uint16_t threshold;	/*!< Distance change of a bin, which is sent. [mm] */
+		} delta;			/*!< Delta encoding of the frames. */
+		uint8_t cartesian;	/*!< Enable or disable the Cartesian coordinates in the data stream. */
+		struct {
+			uint8_t mode;		/*!< Line segments off, alongside or instead of the points. */
+			uint16_t tolerance;	/*!< Maximum distance of a point to its line segment. [mm] */
+			uint8_t points;		/*!< Fewest points of a line segment. */
+		} lines;			/*!< Line segment extraction. */
+		struct {
+			uint8_t mode;		/*!< All points, the foreground points or the blobs. */
+			uint8_t turns;		/*!< Number of turns to learn the background. */
+			uint16_t tolerance;	/*!< Distance of a foreground point to the background. [mm] */
+		} background;		/*!< Background change detection. */
+		struct {
+			uint16_t gate;		/*!< Largest distance of an object to its predicted track, 0 if disabled. [mm] */
+			uint8_t misses;		/*!< Scans a track is predicted without an object. */
+		} tracker;			/*!< Object tracker. */
 		uint16_t engine_sleep;/*!< Ticks before the engine is suspended. */
+		uint8_t engine_standby;	/*!< Enable or disable the engine standby. */
+		uint8_t engine_idle;	/*!< Standby speed of the engine. 0 for the last scan rate. */
+		uint8_t engine_ilc;		/*!< Enable or disable the speed ripple feed-forward. */
 		struct {
 			int16_t left;	/*!< Left azimuth boundary. */
 			int16_t right;	/*!< Right azimuth boundary. */
 		} azimuth_bndry;	/*!< Azimuth boundary. */
 		int16_t azimuth_step;	/*!< Azimuth step size. */
 		uint8_t scan_rate;	/*!< Update rate of the room map. */
+		uint8_t scan_pulses;	/*!< Laser pulses each measurement point. 0 for the maximum. */
+		struct {
+			uint8_t id;		/*!< Sector number. */
+			int16_t left;	/*!< Left sector boundary. */
+			int16_t right;	/*!< Right sector boundary. */
+			int16_t step;	/*!< Azimuth step size, 0 to disable the sector. */
+			uint8_t pulses;	/*!< Laser pulses each measurement point. 0 for the maximum. */
+		} scan_sector;		/*!< Scan sector. */
+		uint16_t scan_arc;	/*!< Target arc length between two points. 0 for fixed steps. */
+		uint8_t scan_profile;	/*!< Selected scan profile. */
+		uint8_t scan_alternate;	/*!< Enable or disable the alternating scan profiles. */
+		uint8_t scan_binning;	/*!< Number of adjacent points pooled into one point. */
+		struct {
+			uint16_t min;	/*!< Near limit of the hits, 0 if disabled. [mm] */
+			uint16_t max;	/*!< Far limit of the hits, 0 if disabled. [mm] */
+		} scan_gate;		/*!< Range gate. */
+		uint8_t scan_walk;	/*!< Distance error of a point without intensity. [mm] */
+		uint8_t scan_calib;	/*!< Number of turns between two calibrations. */
+		struct {
+			uint8_t index;	/*!< Point of the correction table. */
+			int8_t value;	/*!< Distance correction. [mm] */
+		} scan_tcomp;		/*!< Point of the temperature correction table. */
+		struct {
+			uint8_t shift;	/*!< Filter weight of the new distance is 1/2^shift, 0 if disabled. */
+			uint16_t jump;	/*!< Distance change, which resets the filter. [mm] */
+		} scan_filter;		/*!< Temporal filter. */
+		struct {
+			uint8_t median;	/*!< Enable or disable the median of the neighbourhood. */
+			uint16_t edge;	/*!< Distance step of a mixed pixel, 0 if disabled. [mm] */
+			uint8_t drop;	/*!< Drop or flag the rejected points. */
+		} scan_spatial;		/*!< Spatial filter. */
+		struct {
+			int16_t x;		/*!< Offset of the sensor in front direction. [mm] */
+			int16_t y;		/*!< Offset of the sensor in left direction. [mm] */
+			int16_t rotation;	/*!< Azimuth of the sensor front in the vehicle frame. [tenth degree] */
+		} scan_mount;		/*!< Mounting position of the sensor. */
+		struct {
+			uint8_t index;	/*!< Number of the zone. */
+			int16_t left;	/*!< Left zone boundary. [tenth degree] */
+			int16_t right;	/*!< Right zone boundary. [tenth degree] */
+			uint16_t distance;	/*!< Range of the zone, 0 if disabled. [mm] */
+		} scan_zone;		/*!< Protective zone. */
 		/* User error code */
 		uint8_t error_level;	/*!< Level of the command error */
 		/* System malfunction parameters */
@@ -27,7 +27,7 @@
  */
 #define TASK_DATAACQUISITION_NAME		"Acquisition"				/*!< Task name. */
 #define TASK_DATAACQUISITION_PRIORITY	6							/*!< Task Priority. */
-#define TASK_DATAACQUISITION_STACKSIZE	configMINIMAL_STACK_SIZE	/*!< Task Stack size. */
+#define TASK_DATAACQUISITION_STACKSIZE	(configMINIMAL_STACK_SIZE * 2)	/*!< Task Stack size. */
 
 
 /*
@@ -43,7 +43,37 @@
  * Configurations
  * ----------------------------------------------------------------------------
  */
-#define DA_LASERPULSE		30		/*!< Number of laser pulse with 1 scan per second. */
+#define DA_TIMING_MARGIN	10		/*!< Reserved time of each measurement point for the speed variation [percent]. */
+#define DA_ISR_COST_NS		20000	/*!< Assumed interrupt time each measurement point until it is measured [ns]. */
+#define DA_HIT_COST_NS		5000	/*!< Assumed interrupt time each TDC hit until it is measured [ns]. */
+#define DA_GP22_RANGE_NS	2400	/*!< Range of the GP22 measurement mode 1, it times out afterwards [ns]. */
+#define DA_LASER_PERIOD_MIN_NS	10000	/*!< Shortest time between two pulses of the laser driver [ns]. */
+
+/** Time between two laser pulses [ns] of a PWM period register value. The center aligned timer counts up and down with twice BSP_LASER_FREQ. */
+#define DA_LASER_PULSE_NS(period)	((uint32_t)(1000000000ULL * (period) / BSP_LASER_FREQ))
+
+#define DA_ADAPTIVE_MIN_INC	2		/*!< Smallest step of the range adaptive sampling [increments]. */
+#define DA_ADAPTIVE_PERIOD	10		/*!< Period to prepare the adaptive schedule of the next turn [ms]. */
+#define DA_RANGE_BIN_INC	4		/*!< Increments each bin of the range feedback. */
+#define DA_RANGE_BINS		((BSP_QUADENC_INC_PER_TURN+1) / DA_RANGE_BIN_INC)	/*!< Number of range feedback bins. */
+
+/** Maximum measurement points each turn, including the distance calibration. The sectors do not overlap
+ * and the smallest step is DA_ADAPTIVE_MIN_INC. */
+#define DA_SCHEDULE_LENGTH	((DA_AZIMUTH_MAX - DA_AZIMUTH_MIN) * (BSP_QUADENC_INC_PER_TURN+1) / 3600 \
+								/ DA_ADAPTIVE_MIN_INC + DA_SECTOR_MAX + 1)
+
+#define DA_PLAN_OK			0		/*!< The scan configuration is feasible. */
+#define DA_PLAN_TIMING		1		/*!< The laser pulses do not fit into the time between two points. */
+#define DA_PLAN_OVERLAP		2		/*!< Two scan sectors overlap. */
+#define DA_PLAN_BINNING		3		/*!< The pooled laser pulses of a bin exceed the raw data block. */
+
+#define DA_FAULT_POOL		0		/*!< No free raw data block, or no space in the raw data queue. */
+#define DA_FAULT_POINTER	1		/*!< TDC hit or end of a sequence without a raw data block. */
+#define DA_FAULT_TIMING		2		/*!< Point before the last sequence or the last bin is done. */
+#define DA_FAULTS			3		/*!< Number of fault counters. */
+#define DA_FAULT_NO_MARKER	0xFFFFFFFF	/*!< Increments of a fault without a lost point. */
+#define DA_FAULT_RATE		10		/*!< Faults each turn, which are sustained. [percent of the points] */
+#define DA_FAULT_TURNS		3		/*!< Consecutive turns with sustained faults, which stop the data acquisition. */
 
 
 /*
@@ -52,25 +82,75 @@
  * ----------------------------------------------------------------------------
  */
 
+/**
+ * \brief	Scan sector. Each sector has its own point density and laser pulses.
+ */
+typedef struct {
+	int16_t left;				/*!< Left sector boundary. [tenth degree] */
+	int16_t right;				/*!< Right sector boundary. [tenth degree] */
+	int16_t step;				/*!< Step size between two measurement points, 0 if disabled. [tenth degree] */
+	uint8_t pulses;				/*!< Laser pulses each measurement point, 0 for the maximum. */
+} scansector_t;
+
+/**
+ * \brief	Scan configuration. Sector 0 is the main scan area.
+ */
+typedef struct {
+	scansector_t sector[DA_SECTOR_MAX];	/*!< Scan sectors. */
+	uint8_t rate;				/*!< Configured update rate of the hole room map. [turns per second] */
+	uint16_t arc;				/*!< Target arc length between two points, 0 for fixed steps. [mm] */
+	uint8_t binning;			/*!< Number of adjacent points pooled into one point, 1 for no binning. */
+} scanconfig_t;
+
+/**
+ * \brief	Scan profiles. They alternate at the start of each turn, or only the
+ * 			selected profile is used.
+ */
+typedef struct {
+	scanconfig_t profile[DA_PROFILE_MAX];	/*!< Scan configuration of each profile. */
+	uint8_t selected;			/*!< Selected profile, if they do not alternate. */
+	uint8_t alternate;			/*!< TRUE to alternate the profiles each turn. */
+	uint8_t calibration;		/*!< Number of turns between two calibrations of the TDC and the reference mark. */
+} scanprofiles_t;
+
 /**
  * \brief	Data acquisition configurations.
  */
 typedef struct {
 	enum {
 		DATA_ACQUISITION_ENABLE,	/*!< Starts the data acquisition. */
-		DATA_ACQUISITION_DISABLE	/*!< Stops the data acquisition. */
+		DATA_ACQUISITION_DISABLE,	/*!< Stops the data acquisition. */
+		DATA_ACQUISITION_UPDATE		/*!< Changes the scan settings of the running data acquisition at the next turn. */
 	} state;						/*!< New state of the data acquisition. */
 	union {
+		scanprofiles_t scan;		/*!< Scan settings, with the planned laser pulses. Also of the update. */
 		struct {
-			int16_t bndry_left;		/*!< Configured scan area boundary left. [tenth degree] */
-			int16_t bndry_right;	/*!< Configured scan area boundary right. [tenth degree] */
-			int16_t step;			/*!< Configures step size between two measurement points. [tenth degree] */
-			uint8_t rate;			/*!< Configured update rate of the hole room map. [turns per second] */
-		} scan;						/*!< Scan settings. */
-		uint16_t engine_sleep;		/*!< Configured time delay before the engine is suspended in CMD mode. [ms] */
+			uint16_t sleep;			/*!< Configured time delay before the engine is suspended in CMD mode. [ms] */
+			uint8_t rate;			/*!< Standby speed of the engine in CMD mode. 0 to suspend it. [turns per second] */
+		} engine;					/*!< Engine settings. */
 	} param;						/*!< Parameter of the new data acquisition state. */
 } dataacquisition_t;
 
+/**
+ * \brief	Timing plan of a scan sector.
+ */
+typedef struct {
+	uint32_t points;			/*!< Number of measurement points each turn. */
+	uint32_t step_time;			/*!< Time between two measurement points. [ns] */
+	uint32_t point_cost;		/*!< Time to measure one point with the planned laser pulses. [ns] */
+	uint32_t max_pulses;		/*!< Maximum feasible number of laser pulses each point. */
+	uint32_t pulses;			/*!< Planned number of laser pulses each point. */
+} sectorplan_t;
+
+/**
+ * \brief	Timing plan of a scan configuration.
+ */
+typedef struct {
+	sectorplan_t sector[DA_SECTOR_MAX];	/*!< Plan of each sector, zero if disabled. */
+	uint32_t points;			/*!< Number of resulting points each turn, after the binning. */
+	uint32_t points_per_second;	/*!< Resulting points each second. */
+} scanplan_t;
+
 
 /*
  * ----------------------------------------------------------------------------
@@ -87,6 +167,16 @@ extern QueueHandle_t queueDataAcquisition;
  * ----------------------------------------------------------------------------
  */
 extern void taskDataAcquisitionInit(void);
+extern uint8_t taskDataAcquisitionPlan(const scanconfig_t *config, scanplan_t *plan);
+extern uint8_t taskDataAcquisitionPlanPeriod(const scanconfig_t *config, uint16_t period, scanplan_t *plan);
+extern void taskDataAcquisitionIsrCost(uint32_t *azimuth_ns, uint32_t *sequence_ns, uint32_t *hit_ns);
+extern void taskDataAcquisitionBusLoad(uint32_t *spi_bytes, uint32_t *isr);
+extern uint16_t taskDataAcquisitionGatePeriod(uint16_t gate_max);
+extern void taskDataAcquisitionSetPeriod(uint16_t period);
+extern void taskDataAcquisitionSetRange(uint32_t increments, int16_t distance);
+extern void taskDataAcquisitionSetQos(uint8_t level);
+extern void taskDataAcquisitionQosStats(uint32_t *skipped, uint32_t *reduced);
+extern void taskDataAcquisitionFaults(uint32_t *faults);
 
 
 #endif /* TASK_DATAACQUISITION_H_ */
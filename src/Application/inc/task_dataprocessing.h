@@ -25,7 +25,7 @@
  */
 #define TASK_DATAPROC_NAME			"Data Processing"			/*!< Task name. */
 #define TASK_DATAPROC_PRIORITY		2							/*!< Task Priority. */
-#define TASK_DATAPROC_STACKSIZE		configMINIMAL_STACK_SIZE	/*!< Task Stack size. */
+#define TASK_DATAPROC_STACKSIZE		(configMINIMAL_STACK_SIZE * 3)	/*!< Task Stack size. The deepest output chain needs about 1 KB. */
 
 
 /*
@@ -35,6 +35,8 @@
  */
 #define Q_RAWDATA_LENGTH			30			/*!< Memory pool and queue length of the raw data. */
 #define MAX_RAWDATA_LENGTH			50			/*!< Maximum measurement points each point of the room map. */
+#define Q_DATAPROCESSING_LENGTH		4			/*!< Queue length of the data processing settings. */
+#define Q_RAWDATA_FAULT_LENGTH		8			/*!< Queue length of the points lost by a fault. */
 
 
 /*
@@ -44,6 +46,81 @@
  */
 #define VERILOG_OF_LIGHT			299792458	/*!< Verilog of the light [m/s]. Source: Wikipedia. */
 #define UINT_FACTOR					211.7335	/*!< Calculated factor to the unit conversion. */
+#define DP_AZIMUTH_SCAN				-2048		/*!< Azimuth of the scan start marker, its distance is the profile and scan number. */
+#define DP_PULSE_WIDTH_UNIT			0x80		/*!< Pulse width ratio of 1.0 (PW1ST is a fixed point number with 7 fractional bits). */
+#define DP_HITS_CLASSES				4			/*!< Classes of the per bin hit statistics, each a quarter of the expected hits. */
+#define DP_INTENSITY_UNIT			0x800		/*!< Intensity of a point with all hits and a pulse width ratio of 1.0. */
+#define DP_INTENSITY_MAX			0xFFF		/*!< Maximum intensity, it is a 12 bit value. */
+#define DP_FILTER_BIN_INC			DA_ADAPTIVE_MIN_INC	/*!< Increments each bin of the temporal filter. */
+#define DP_FILTER_BINS				((BSP_QUADENC_INC_PER_TURN+1) / DP_FILTER_BIN_INC)	/*!< Number of temporal filter bins. */
+#define DP_FILTER_FRACTION			4			/*!< Fractional bits of the filter state. */
+#define DP_SPATIAL_WINDOW			3			/*!< Points of the spatial filter window, one point of latency. */
+#define DP_SPATIAL_GAP_INC			40			/*!< Largest azimuth gap between two neighbours of the spatial filter [increments]. */
+#define DP_DISTANCE_REJECTED		-1			/*!< Distance of a point flagged by the spatial filter, below all measured distances. It is sent as 0. */
+#define DP_FRAME_HEADER_LENGTH		14			/*!< Characters of the frame header: scan marker, points, start and end tick. */
+#define DP_FRAME_TICK_DIGITS		4			/*!< Base64 digits of each tick in the frame header, the lower 24 bits. */
+#define DP_FRAME_POINTS_DIGITS		2			/*!< Base64 digits of the number of points in the frame header. */
+
+#define DP_AZIMUTH_KEYFRAME			-2047		/*!< Azimuth of the marker of a delta encoded keyframe, its distance is the profile and scan number. */
+#define DP_AZIMUTH_DELTA			-2046		/*!< Azimuth of the marker of a delta encoded frame, its distance is the profile and scan number. */
+#define DP_AZIMUTH_CARTESIAN		-2045		/*!< Azimuth of the marker of a frame with Cartesian coordinates, its distance is the profile and scan number. */
+#define DP_AZIMUTH_FAULT			-2044		/*!< Azimuth of the marker of a point lost by a fault, its distance is the azimuth of the point. */
+#define DP_DELTA_BIN_INC			DP_FILTER_BIN_INC	/*!< Increments each bin of the delta encoding. */
+#define DP_DELTA_BINS				DP_FILTER_BINS		/*!< Number of bins of the delta encoding. */
+#define DP_DELTA_BITMAP_LENGTH		((DP_DELTA_BINS + 5) / 6)	/*!< Characters of the bitmap with the sent bins, 6 bins each character. */
+#define DP_DELTA_VARINT_LENGTH		4			/*!< Maximum characters of the distance difference of a bin. */
+#define DP_DELTA_EMPTY				INT16_MIN	/*!< Distance of a bin without a point. */
+#define DP_DELTA_CRC_DIGITS			3			/*!< Base64 digits of the CRC16 behind each delta encoded frame. */
+
+#define DP_CARTESIAN_TABLE			(BSP_QUADENC_INC_PER_TURN+1)	/*!< Entries of the sine and cosine tables, one each increment. */
+#define DP_CARTESIAN_DIGITS			3			/*!< Base64 digits of each Cartesian coordinate, signed 18 bits. */
+
+#define DP_LINES_MAX				64			/*!< Maximum line segments each scan. */
+#define DP_LINES_GAP				200			/*!< Largest distance between two points of a line segment [mm]. */
+#define DP_LINES_BUDGET_US			5000		/*!< CPU time of the line extraction each scan, it stops afterwards [us]. */
+#define DP_LINES_HEADER_LENGTH		6			/*!< Characters of the line header: scan marker and number of lines. */
+#define DP_LINE_LENGTH				16			/*!< Characters of a line segment: both endpoints, residual and points. */
+#define DP_LINES_LENGTH				(DP_LINES_HEADER_LENGTH + DP_LINES_MAX * DP_LINE_LENGTH)	/*!< Maximum characters of the lines of a scan. */
+
+#define DP_ZONE_HITS				2			/*!< Consecutive points within a zone, which raise its alarm. */
+#define DP_ZONE_ALARM_LED			BSP_LED_ORANGE	/*!< Output of the zone alarm. */
+
+#define DP_BACKGROUND_BIN_INC		DP_FILTER_BIN_INC	/*!< Increments each bin of the background. */
+#define DP_BACKGROUND_BINS			DP_FILTER_BINS		/*!< Number of background bins. */
+#define DP_BACKGROUND_EMPTY			0xFFFF		/*!< Near limit of a bin without an echo while learning. */
+#define DP_BLOB_POINTS				2			/*!< Fewest foreground points of a blob. */
+#define DP_BLOB_GAP					200			/*!< Largest distance step between two points of a blob [mm]. */
+#define DP_BLOB_LENGTH				8			/*!< Characters of a blob: both azimuth boundaries, nearest distance and points. */
+
+#define DP_CLUSTER_MAX				32			/*!< Maximum clustered objects each scan, the others are dropped. */
+#define DP_TRACK_MAX				16			/*!< Tracks of the arena. */
+#define DP_TRACK_CONFIRM			2			/*!< Scans with an object until the track is sent. */
+#define DP_TRACK_ALPHA				0.5f		/*!< Weight of the position residual of the constant velocity filter. */
+#define DP_TRACK_BETA				0.2f		/*!< Weight of the velocity residual of the constant velocity filter. */
+#define DP_TRACK_PAUSE_MS			1000		/*!< Time between two scans, which clears the tracks [ms]. */
+#define DP_TRACK_ID_MAX				0xFFF		/*!< Largest track ID, the IDs start again at 1 afterwards. */
+#define DP_OBJECTS_HEADER_LENGTH	6			/*!< Characters of the object header: scan marker and number of objects. */
+#define DP_OBJECT_LENGTH			16			/*!< Characters of an object: ID, centroid, velocity and extent. */
+#define DP_OBJECTS_LENGTH			(DP_OBJECTS_HEADER_LENGTH + DP_TRACK_MAX * DP_OBJECT_LENGTH)	/*!< Maximum characters of the objects of a scan. */
+
+#define DP_CAPTURE_LENGTH			(64 * 1024)	/*!< Storage of the burst capture in the CCM RAM [bytes]. */
+#define DP_CAPTURE_CRC_DIGITS		3			/*!< Base64 digits of the CRC16 behind each captured frame. */
+
+#define DP_RAW_BUFFERS				4			/*!< Raw records, which are sent at the same time. */
+#define DP_RAW_HEADER_LENGTH		28			/*!< Characters of the raw record header, see rawDump(). */
+#define DP_RAW_HIT_DIGITS			6			/*!< Base64 digits of each TDC hit, 32 bits. */
+#define DP_RAW_LENGTH				(DP_RAW_HEADER_LENGTH + MAX_RAWDATA_LENGTH * DP_RAW_HIT_DIGITS + DP_CAPTURE_CRC_DIGITS)	/*!< Maximum characters of a raw record. */
+
+#define DP_QOS_DECIMATE				1			/*!< Governor level, which sends every second point. */
+#define DP_QOS_PULSES				2			/*!< Governor level, which also halves the laser pulses. */
+#define DP_QOS_SKIP					3			/*!< Governor level, which also skips every second bin. */
+#define DP_QOS_HIGH					75			/*!< Pressure, which raises the governor level [percent]. */
+#define DP_QOS_LOW					25			/*!< Pressure, which allows to lower the governor level [percent]. */
+#define DP_QOS_RAISE_MS				100			/*!< Time between two raised governor levels [ms]. */
+#define DP_QOS_LOWER_MS				1000		/*!< Time of a low pressure, which lowers the governor level [ms]. */
+
+/** Maximum characters of a frame, a scan with the maximum points and the intensity. */
+#define DP_FRAME_LENGTH				(DP_FRAME_HEADER_LENGTH + DA_SCHEDULE_LENGTH * DATA_MESSAGE_STRING_LENGTH)
 
 
 /*
@@ -52,6 +129,15 @@
  * ----------------------------------------------------------------------------
  */
 
+/**
+ * \brief	Protective zone. An object within the range raises an alarm.
+ */
+typedef struct {
+	int16_t left;				/*!< Left zone boundary. [tenth degree] */
+	int16_t right;				/*!< Right zone boundary. [tenth degree] */
+	uint16_t distance;			/*!< Range of the zone, 0 if disabled. [mm] */
+} zone_t;
+
 /**
  * \brief	Raw data structure of a point of the room map.
  */
@@ -60,9 +146,119 @@ typedef struct {
 	uint32_t cal_resonator;		/*!< Raw calibration value of the resonator. */
 	uint32_t expected_points;	/*!< Number of expected raw data points. */
 	uint32_t raw_ctr;			/*!< Raw data counter. */
+	uint8_t scan_id;			/*!< Number of the turn. */
+	uint8_t profile;			/*!< Scan profile of the turn. */
+	uint8_t pulse_width;		/*!< Pulse width ratio of the first wave (PW1ST), 0 if not measured. */
+	uint8_t calibrate;			/*!< TRUE if the reference mark is measured in this turn. */
+	uint32_t temperature;		/*!< Ratio of the sensor to the reference discharge time, 0 if not measured. [1/65536] */
+	uint32_t cycles;			/*!< Cycle counter at the end of the measurement. [CPU cycles] */
 	uint32_t raw[MAX_RAWDATA_LENGTH];	/*!< Raw data. */
 } rawdata_t;
 
+/**
+ * \brief	Point lost by a fault of the data acquisition.
+ */
+typedef struct {
+	uint32_t increments;		/*!< Azimuth in increments. */
+	uint8_t scan_id;			/*!< Number of the turn. */
+} rawdatafault_t;
+
+/**
+ * \brief	Data processing configurations. They are taken over with the next
+ * 			raw data.
+ */
+typedef struct {
+	enum {
+		DATA_PROCESSING_GATE,		/*!< Sets the range gate. */
+		DATA_PROCESSING_INTENSITY,	/*!< Enable/disable the intensity in the output stream. */
+		DATA_PROCESSING_WALK,		/*!< Sets the walk error correction. */
+		DATA_PROCESSING_TCOMP,		/*!< Sets a point of the temperature correction table. */
+		DATA_PROCESSING_FILTER,		/*!< Sets the temporal filter. */
+		DATA_PROCESSING_SPATIAL,	/*!< Sets the spatial filter. */
+		DATA_PROCESSING_FRAME,		/*!< Enable/disable the frames in the output stream. */
+		DATA_PROCESSING_DELTA,		/*!< Sets the delta encoding of the frames. */
+		DATA_PROCESSING_CARTESIAN,	/*!< Enable/disable the Cartesian coordinates in the output stream. */
+		DATA_PROCESSING_MOUNT,		/*!< Sets the mounting position of the sensor. */
+		DATA_PROCESSING_LINES,		/*!< Sets the line segment extraction. */
+		DATA_PROCESSING_ZONE,		/*!< Sets a protective zone. */
+		DATA_PROCESSING_BACKGROUND,	/*!< Sets and learns the background change detection. */
+		DATA_PROCESSING_TRACKER,	/*!< Sets the object tracker. */
+		DATA_PROCESSING_CAPTURE,	/*!< Starts or stops the burst capture. */
+		DATA_PROCESSING_RAW,		/*!< Enable/disable the raw TDC data instead of the points. */
+		DATA_PROCESSING_QOS,		/*!< Enable/disable the governor of the data stream. */
+		DATA_PROCESSING_MARKER		/*!< Enable/disable the scan start marker in the data stream. */
+	} config;						/*!< Configuration to change. */
+	union {
+		struct {
+			uint16_t min;			/*!< Near limit of the hits, 0 if disabled. [mm] */
+			uint16_t max;			/*!< Far limit of the hits, 0 if disabled. [mm] */
+		} gate;						/*!< Range gate. */
+		uint8_t intensity;			/*!< TRUE to append the intensity to each point. */
+		uint8_t walk;				/*!< Distance error of a point without intensity, 0 if disabled. [mm] */
+		struct {
+			uint8_t index;			/*!< Point of the correction table. */
+			int8_t value;			/*!< Distance correction. [mm] */
+		} tcomp;					/*!< Point of the temperature correction table. */
+		struct {
+			uint8_t shift;			/*!< Filter weight of the new distance is 1/2^shift, 0 if disabled. */
+			uint16_t jump;			/*!< Distance change, which resets the filter of a bin. [mm] */
+		} filter;					/*!< Temporal filter. */
+		struct {
+			uint8_t median;			/*!< TRUE to replace each distance by the median of its neighbourhood. */
+			uint16_t edge;			/*!< Distance step to both neighbours of a mixed pixel, 0 if disabled. [mm] */
+			uint8_t drop;			/*!< TRUE to drop rejected points, FALSE to flag them. */
+		} spatial;					/*!< Spatial filter. */
+		uint8_t frame;				/*!< TRUE to send each scan as one frame. */
+		struct {
+			uint8_t keyframe;		/*!< Frames between two keyframes, 0 if disabled. */
+			uint16_t threshold;		/*!< Distance change of a bin, which is sent. [mm] */
+		} delta;					/*!< Delta encoding of the frames. */
+		uint8_t cartesian;			/*!< TRUE to send the points in Cartesian coordinates. */
+		struct {
+			int16_t x;				/*!< Offset of the sensor in front direction. [mm] */
+			int16_t y;				/*!< Offset of the sensor in left direction. [mm] */
+			int16_t rotation;		/*!< Azimuth of the sensor front in the vehicle frame. [tenth degree] */
+		} mount;					/*!< Mounting position of the sensor. */
+		struct {
+			uint8_t mode;			/*!< DP_LINES_OFF, DP_LINES_ALONGSIDE or DP_LINES_ONLY. */
+			uint16_t tolerance;		/*!< Maximum distance of a point to its line segment. [mm] */
+			uint8_t points;			/*!< Fewest points of a line segment. */
+		} lines;					/*!< Line segment extraction. */
+		struct {
+			uint8_t index;			/*!< Number of the zone. */
+			zone_t zone;			/*!< Zone boundary and range. */
+		} zone;						/*!< Protective zone. */
+		struct {
+			uint8_t mode;			/*!< DP_BACKGROUND_OFF, DP_BACKGROUND_POINTS or DP_BACKGROUND_BLOBS. */
+			uint8_t turns;			/*!< Number of turns to learn the background. */
+			uint16_t tolerance;		/*!< Distance of a foreground point to the background. [mm] */
+		} background;				/*!< Background change detection. */
+		struct {
+			uint16_t gate;			/*!< Largest distance of an object to its predicted track, 0 if disabled. [mm] */
+			uint8_t misses;			/*!< Scans a track is predicted without an object. */
+		} tracker;					/*!< Object tracker. */
+		uint8_t capture;			/*!< Number of scans to capture, 0 to stop the capture. */
+		uint8_t raw;				/*!< TRUE to send the raw TDC data instead of the points. */
+		uint8_t qos;				/*!< TRUE to degrade the data stream under load. */
+		uint8_t marker;				/*!< TRUE to send the scan start marker each turn. */
+	} param;						/*!< Parameter of the configuration. */
+} dataprocessing_t;
+
+/**
+ * \brief	Frame with all encoded points of a scan. The header is written in
+ * 			front of the points when the scan is complete.
+ */
+typedef struct {
+	uint8_t scan_id;			/*!< Number of the turn. */
+	uint8_t profile;			/*!< Scan profile of the turn. */
+	uint16_t points;			/*!< Number of points. */
+	TickType_t start;			/*!< Tick of the scan start. */
+	TickType_t end;				/*!< Tick of the scan end. */
+	uint32_t length;			/*!< Number of encoded characters, including the header. */
+	volatile uint8_t busy;		/*!< TRUE while the gatekeeper sends the frame. */
+	char *data;					/*!< Terminated header and points. */
+} frame_t;
+
 
 /*
  * ----------------------------------------------------------------------------
@@ -71,6 +267,9 @@ typedef struct {
  */
 extern TaskHandle_t taskDataProcessingHandle;
 extern QueueHandle_t queueRawDataPtr;
+extern QueueHandle_t queueDataProcessing;
+extern QueueSetHandle_t queueDataProcessingSet;
+extern QueueHandle_t queueRawDataFault;
 extern MemPoolManager memRawData;
 
 
@@ -80,6 +279,19 @@ extern MemPoolManager memRawData;
  * ----------------------------------------------------------------------------
  */
 extern void taskDataProcessingInit(void);
+extern int16_t taskDataProcessingGetTemperature(void);
+extern void taskDataProcessingFilterCost(uint32_t *temporal_ns, uint32_t *spatial_ns);
+extern void taskDataProcessingGetHits(uint32_t *hit_ratio, uint32_t *valid_ratio);
+extern void taskDataProcessingGetBins(uint32_t *bins);
+extern const frame_t *taskDataProcessingLatestFrame(uint32_t *overruns);
+extern void taskDataProcessingLineStats(uint32_t *lines, uint32_t *scan_us, uint32_t *overruns);
+extern void taskDataProcessingZoneStats(uint32_t *events, uint32_t *latency_us, uint32_t *dropped);
+extern void taskDataProcessingOutputStats(uint32_t *suppressed, uint32_t *point_ns);
+extern void taskDataProcessingRawStats(uint32_t *records, uint32_t *dropped);
+extern uint32_t taskDataProcessingCaptureFrames(uint32_t *bytes);
+extern const char *taskDataProcessingCaptureFrame(uint32_t index, uint32_t *length);
+extern void taskDataProcessingTrackerStats(uint32_t *objects, uint32_t *scan_us, uint32_t *dropped, uint32_t *overruns);
+extern void taskDataProcessingQosStats(uint8_t *level, uint8_t *pressure, uint32_t *decimated, uint32_t *dropped);
 
 
 #endif /* TASK_DATAPROCESSING_H_ */
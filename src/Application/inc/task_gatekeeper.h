@@ -35,7 +35,10 @@
 #define Q_MESSAGE_LENGTH			10		/*!< Queue length of the messages. */
 #define MESSAGE_STRING_LENGTH		40		/*!< Maximal length of each message. */
 #define Q_MESSAGE_DATA_LENGTH		40		/*!< Queue length of the data messages. */
-#define DATA_MESSAGE_STRING_LENGTH	4		/*!< Number of characters each data message. */
+#define DATA_MESSAGE_STRING_LENGTH	8		/*!< Maximum number of characters each data message. Shorter messages are terminated. */
+#define Q_MESSAGE_BLOCK_LENGTH		4		/*!< Queue length of the message blocks. */
+#define Q_MESSAGE_ALARM_LENGTH		4		/*!< Queue length of the alarm messages. */
+#define DATA_MESSAGE_TIMEOUT		2		/*!< Waiting cycles of 10 ms for the space of a data message, it is dropped afterwards. */
 
 
 /*
@@ -48,10 +51,19 @@
 #define MSG_TYPE_CONF			'@'		/*!< A configuration value. */
 #define MSG_TYPE_STATE			'#'		/*!< System state message. */
 #define MSG_TYPE_DATA			'$'		/*!< Data point of the room map. */
+#define MSG_TYPE_FRAME			'%'		/*!< All data points of a scan. */
+#define MSG_TYPE_LINES			'&'		/*!< Line segments of a scan. */
+#define MSG_TYPE_BLOB			'*'		/*!< Foreground object in front of the learned background. */
+#define MSG_TYPE_OBJECTS		'^'		/*!< Tracked objects of a scan. */
+#define MSG_TYPE_CAPTURE		'~'		/*!< Frame of the burst capture, with its CRC. */
+#define MSG_TYPE_RAW			'!'		/*!< Raw TDC data of a point, with its CRC. */
 
 #define IS_MSG_TYPE(mt) (((mt) == MSG_TYPE_ECHO) || ((mt) == MSG_TYPE_RSP)|| \
 				((mt) == MSG_TYPE_CONF) || ((mt) == MSG_TYPE_STATE) \
-				((mt) == MSG_TYPE_DATA))
+				((mt) == MSG_TYPE_DATA) || ((mt) == MSG_TYPE_FRAME) || \
+				((mt) == MSG_TYPE_LINES) || ((mt) == MSG_TYPE_BLOB) || \
+				((mt) == MSG_TYPE_OBJECTS) || ((mt) == MSG_TYPE_CAPTURE) || \
+				((mt) == MSG_TYPE_RAW))
 
 #define MSG_FRAME_END			"\r\n"	/*!< End of a message frame */
 
@@ -69,6 +81,17 @@ typedef struct {
 	char msg[MESSAGE_STRING_LENGTH];	/*!< Message, without the frame. */
 } message_t;
 
+/**
+ * \brief	Large message, which is sent directly from the storage of the
+ * 			sender. The sender must not change it until it is released.
+ */
+typedef struct {
+	char type;					/*!< Message type. */
+	const char *msg;			/*!< Terminated message, without the frame. */
+	uint32_t length;			/*!< Number of characters. */
+	volatile uint8_t *busy;		/*!< Cleared after the message was sent. */
+} messageblock_t;
+
 
 /*
  * ----------------------------------------------------------------------------
@@ -78,6 +101,9 @@ typedef struct {
 extern TaskHandle_t taskGatekeeperHandle;
 extern QueueHandle_t queueMessage;
 extern QueueHandle_t queueMessageData;
+extern QueueHandle_t queueMessageBlock;
+extern QueueHandle_t queueMessageAlarm;
+extern SemaphoreHandle_t semaphoreMessageAlarm;
 extern QueueSetHandle_t queueMessageSet;
 extern SemaphoreHandle_t mutexTxCircBuf;
 
@@ -88,6 +114,7 @@ extern SemaphoreHandle_t mutexTxCircBuf;
  * ----------------------------------------------------------------------------
  */
 extern void taskGatekeeperInit(void);
+extern uint32_t taskGatekeeperDataDropped(void);
 
 
 #endif /* TASK_GATEKEEPER_H_ */
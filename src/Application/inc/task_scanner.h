@@ -46,8 +46,14 @@
 #define ENGINE_CONTROLER_TA			1		/*!< Time interval. */
 #define ENGINE_SETTING_TIME			800		/*!< Engine speed controller setting time [ms] */
 #define ENGINE_RISE_TIME			180		/*!< Engine speed controller rise time [ms] */
+#define ENGINE_DELTA_SETTING_TIME	100		/*!< Minimum setting time after a speed change of the running engine [ms] */
 #define ENGINE_MAX_POWER			4199	/*!< Maximum power. Must be smaller than BSP_ENGINE_PWM_PERIOD! */
 
+#define ENGINE_ILC_BINS				40		/*!< Number of angle bins of the speed ripple feed-forward table. Must divide BSP_QUADENC_INC_PER_TURN+1. */
+#define ENGINE_ILC_GAIN				60		/*!< Learning gain of the feed-forward table [power per increment/ms]. */
+#define ENGINE_ILC_LIMIT			800		/*!< Maximum absolute feed-forward of an angle bin [power]. */
+#define ENGINE_ILC_LEAD				1		/*!< Phase lead of the applied feed-forward [bins]. */
+
 
 /*
  * ----------------------------------------------------------------------------
@@ -76,6 +82,8 @@ extern QueueHandle_t queueSpeed;
  * ----------------------------------------------------------------------------
  */
 extern void taskScannerInit(void);
+extern void taskScannerSetIlc(uint8_t enable);
+extern void taskScannerGetRipple(uint16_t *initial, uint16_t *current);
 
 
 #endif /* TASK_SCANNER_H_ */
@@ -236,9 +236,10 @@ void* parseCommand(char **msg) {
 	uint8_t success = 0;
 	event_t resolved_command;
 	msg_filter_t next_func;
+	int32_t number;
 
 	switch (**msg) {
-		/* cmd */
+		/* cmd, capture */
 		case 'c':
 			if (strcmp(*msg, "cmd") == 0) {
 				/* Send command to the controller */
@@ -247,6 +248,24 @@ void* parseCommand(char **msg) {
 				next_func = NULL;
 				success = 1;
 			}
+			else if (strncmp(*msg, "capture ", 8) == 0) {
+				/* Check the user parameters */
+				*msg += 8;
+				if (parseParamNumber(msg, 1, &number)) {
+					/* Check if the value were in bound */
+					if (number > 0 && number <= DP_CAPTURE_SCANS_MAX) {
+						resolved_command.event = UC_Capture;
+						resolved_command.param.capture = number;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				next_func = NULL;
+				success = 1;
+			}
 			break;
 
 		/* data */
@@ -384,8 +403,70 @@ void* parseCommandSet(char **msg) {
 void* parseCommandSetComm(char **msg) {
 	uint8_t success = 0;
 	event_t resolved_command;
+	int32_t number1, number2, number3;
 
 	switch (**msg) {
+		/* set comm background */
+		case 'b':
+			if (strncmp(*msg, "background ", 11) == 0) {
+				/* Check the user parameters */
+				*msg += 11;
+				if (parseParamNumber(msg, 0, &number1) && parseParamNumber(msg, 0, &number2)
+						&& parseParamNumber(msg, 1, &number3)) {
+					/* Check if the value were in bound */
+					if (number1 >= DP_BACKGROUND_OFF && number1 <= DP_BACKGROUND_BLOBS
+							&& number2 > 0 && number2 <= DP_BACKGROUND_TURNS_MAX
+							&& number3 > 0 && number3 <= DP_BACKGROUND_TOLERANCE_MAX) {
+						resolved_command.event = UC_SetCommBackground;
+						resolved_command.param.background.mode = number1;
+						resolved_command.param.background.turns = number2;
+						resolved_command.param.background.tolerance = number3;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
+
+		/* set comm cartesian */
+		case 'c':
+			if (strncmp(*msg, "cartesian ", 10) == 0) {
+				/* Check the user parameters */
+				*msg += 10;
+				if (parseParamOnOff(msg, 1, &(resolved_command.param.cartesian))) {
+					resolved_command.event = UC_SetCommCartesian;
+					xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+				}
+				success = 1;
+			}
+			break;
+
+		/* set comm delta */
+		case 'd':
+			if (strncmp(*msg, "delta ", 6) == 0) {
+				/* Check the user parameters */
+				*msg += 6;
+				if (parseParamNumber(msg, 0, &number1) && parseParamNumber(msg, 1, &number2)) {
+					/* Check if the value were in bound, a keyframe period of 0 disables it */
+					if (number1 >= 0 && number1 <= 0xFF && number2 >= 0 && number2 <= 0xFFF) {
+						resolved_command.event = UC_SetCommDelta;
+						resolved_command.param.delta.keyframe = number1;
+						resolved_command.param.delta.threshold = number2;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
+
 		/* set comm echo */
 		case 'e':
 			if (strncmp(*msg, "echo ", 5) == 0) {
@@ -399,7 +480,108 @@ void* parseCommandSetComm(char **msg) {
 			}
 			break;
 
-		/* set comm respmsg */
+		/* set comm frame */
+		case 'f':
+			if (strncmp(*msg, "frame ", 6) == 0) {
+				/* Check the user parameters */
+				*msg += 6;
+				if (parseParamOnOff(msg, 1, &(resolved_command.param.frame))) {
+					resolved_command.event = UC_SetCommFrame;
+					xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+				}
+				success = 1;
+			}
+			break;
+
+		/* set comm intensity */
+		case 'i':
+			if (strncmp(*msg, "intensity ", 10) == 0) {
+				/* Check the user parameters */
+				*msg += 10;
+				if (parseParamOnOff(msg, 1, &(resolved_command.param.intensity))) {
+					resolved_command.event = UC_SetCommIntensity;
+					xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+				}
+				success = 1;
+			}
+			break;
+
+		/* set comm lines */
+		case 'l':
+			if (strncmp(*msg, "lines ", 6) == 0) {
+				/* Check the user parameters */
+				*msg += 6;
+				if (parseParamNumber(msg, 0, &number1) && parseParamNumber(msg, 0, &number2)
+						&& parseParamNumber(msg, 1, &number3)) {
+					/* Check if the value were in bound */
+					if (number1 >= DP_LINES_OFF && number1 <= DP_LINES_ONLY
+							&& number2 > 0 && number2 <= DP_LINES_TOLERANCE_MAX
+							&& number3 >= DP_LINES_POINTS_MIN && number3 <= DP_LINES_POINTS_MAX) {
+						resolved_command.event = UC_SetCommLines;
+						resolved_command.param.lines.mode = number1;
+						resolved_command.param.lines.tolerance = number2;
+						resolved_command.param.lines.points = number3;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
+
+		/* set comm marker */
+		case 'm':
+			if (strncmp(*msg, "marker ", 7) == 0) {
+				/* Check the user parameters */
+				*msg += 7;
+				if (parseParamOnOff(msg, 1, &(resolved_command.param.marker))) {
+					resolved_command.event = UC_SetCommMarker;
+					xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+				}
+				success = 1;
+			}
+			break;
+
+		/* set comm tracker */
+		case 't':
+			if (strncmp(*msg, "tracker ", 8) == 0) {
+				/* Check the user parameters */
+				*msg += 8;
+				if (parseParamNumber(msg, 0, &number1) && parseParamNumber(msg, 1, &number2)) {
+					/* Check if the value were in bound, a gate of 0 disables the tracker */
+					if (number1 >= 0 && number1 <= DP_TRACKER_GATE_MAX
+							&& number2 > 0 && number2 <= DP_TRACKER_MISSES_MAX) {
+						resolved_command.event = UC_SetCommTracker;
+						resolved_command.param.tracker.gate = number1;
+						resolved_command.param.tracker.misses = number2;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
+
+		/* set comm qos */
+		case 'q':
+			if (strncmp(*msg, "qos ", 4) == 0) {
+				/* Check the user parameters */
+				*msg += 4;
+				if (parseParamOnOff(msg, 1, &(resolved_command.param.qos))) {
+					resolved_command.event = UC_SetCommQos;
+					xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+				}
+				success = 1;
+			}
+			break;
+
+		/* set comm respmsg, set comm raw */
 		case 'r':
 			if (strncmp(*msg, "respmsg ", 8) == 0) {
 				/* Check the user parameters */
@@ -410,6 +592,15 @@ void* parseCommandSetComm(char **msg) {
 				}
 				success = 1;
 			}
+			else if (strncmp(*msg, "raw ", 4) == 0) {
+				/* Check the user parameters */
+				*msg += 4;
+				if (parseParamOnOff(msg, 1, &(resolved_command.param.raw))) {
+					resolved_command.event = UC_SetCommRaw;
+					xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+				}
+				success = 1;
+			}
 			break;
 	}
 
@@ -437,12 +628,59 @@ void* parseCommandSetComm(char **msg) {
 void* parseCommandSetScan(char **msg) {
 	uint8_t success = 0;
 	event_t resolved_command;
-	int32_t number1, number2;
+	int32_t number1, number2, number3, number4, number5;
 
 	switch (**msg) {
-		/* set scan bndry */
+		/* set scan arc, set scan alternate */
+		case 'a':
+			if (strncmp(*msg, "alternate ", 10) == 0) {
+				/* Check the user parameters */
+				*msg += 10;
+				if (parseParamOnOff(msg, 1, &(resolved_command.param.scan_alternate))) {
+					resolved_command.event = UC_SetScanAlternate;
+					xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+				}
+				success = 1;
+			}
+			else if (strncmp(*msg, "arc ", 4) == 0) {
+				/* Check the user parameters */
+				*msg += 4;
+				if (parseParamNumber(msg, 1, &number1)) {
+					/* Check if the value were in bound */
+					if (number1 >= 0 && number1 <= DA_ARC_MAX) {
+						resolved_command.event = UC_SetScanArc;
+						resolved_command.param.scan_arc = number1;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
+
+		/* set scan bndry, set scan binning */
 		case 'b':
-			if (strncmp(*msg, "bndry ", 6) == 0) {
+			if (strncmp(*msg, "binning ", 8) == 0) {
+				/* Check the user parameters */
+				*msg += 8;
+				if (parseParamNumber(msg, 1, &number1)) {
+					/* Check if the value were in bound */
+					if (number1 > 0 && number1 <= DA_BINNING_MAX) {
+						resolved_command.event = UC_SetScanBinning;
+						resolved_command.param.scan_binning = number1;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			else if (strncmp(*msg, "bndry ", 6) == 0) {
 				/* Check the user parameters */
 				*msg += 6;
 				if (parseParamNumber(msg, 0, &number1) && parseParamNumber(msg, 1, &number2)) {
@@ -462,9 +700,100 @@ void* parseCommandSetScan(char **msg) {
 			}
 			break;
 
-		/* set scan step */
+		/* set scan calib */
+		case 'c':
+			if (strncmp(*msg, "calib ", 6) == 0) {
+				/* Check the user parameters */
+				*msg += 6;
+				if (parseParamNumber(msg, 1, &number1)) {
+					/* Check if the value were in bound */
+					if (number1 > 0 && number1 <= DA_CALIB_MAX) {
+						resolved_command.event = UC_SetScanCalib;
+						resolved_command.param.scan_calib = number1;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
+
+		/* set scan filter */
+		case 'f':
+			if (strncmp(*msg, "filter ", 7) == 0) {
+				/* Check the user parameters */
+				*msg += 7;
+				if (parseParamNumber(msg, 0, &number1) && parseParamNumber(msg, 1, &number2)) {
+					/* Check if the value were in bound */
+					if (number1 >= 0 && number1 <= DP_FILTER_SHIFT_MAX && number2 > 0 && number2 <= 0xFFF) {
+						resolved_command.event = UC_SetScanFilter;
+						resolved_command.param.scan_filter.shift = number1;
+						resolved_command.param.scan_filter.jump = number2;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
+
+		/* set scan gate */
+		case 'g':
+			if (strncmp(*msg, "gate ", 5) == 0) {
+				/* Check the user parameters */
+				*msg += 5;
+				if (parseParamNumber(msg, 0, &number1) && parseParamNumber(msg, 1, &number2)) {
+					/* Check if the value were in bound, a far limit of 0 disables it */
+					if (number1 >= 0 && number1 <= 0xFFF && number2 >= 0 && number2 <= 0xFFF && (number2 == 0 || number1 < number2)) {
+						resolved_command.event = UC_SetScanGate;
+						resolved_command.param.scan_gate.min = (uint16_t) number1;
+						resolved_command.param.scan_gate.max = (uint16_t) number2;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
+
+		/* set scan step, set scan sector, set scan spatial */
 		case 's':
-			if (strncmp(*msg, "step ", 5) == 0) {
+			if (strncmp(*msg, "sector ", 7) == 0) {
+				/* Check the user parameters */
+				*msg += 7;
+				if (parseParamNumber(msg, 0, &number1) && parseParamNumber(msg, 0, &number2)
+						&& parseParamNumber(msg, 0, &number3) && parseParamNumber(msg, 0, &number4)
+						&& parseParamNumber(msg, 1, &number5)) {
+					/* Check if the value were in bound */
+					if (number1 > 0 && number1 < DA_SECTOR_MAX
+							&& number2 >= DA_AZIMUTH_MIN && number2 <= number3 && number3 <= DA_AZIMUTH_MAX
+							&& (number4 == 0 || (number4 >= 18 && number4 <= 3600))
+							&& number5 >= 0 && number5 <= DA_LASERPULSE_MAX) {
+						resolved_command.event = UC_SetScanSector;
+						resolved_command.param.scan_sector.id = number1;
+						resolved_command.param.scan_sector.left = (int16_t) number2;
+						resolved_command.param.scan_sector.right = (int16_t) number3;
+						resolved_command.param.scan_sector.step = (int16_t) number4;
+						resolved_command.param.scan_sector.pulses = number5;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			else if (strncmp(*msg, "step ", 5) == 0) {
 				/* Check the user parameters */
 				*msg += 5;
 				if (parseParamNumber(msg, 1, &number1)) {
@@ -481,6 +810,89 @@ void* parseCommandSetScan(char **msg) {
 				}
 				success = 1;
 			}
+			else if (strncmp(*msg, "spatial ", 8) == 0) {
+				/* Check the user parameters */
+				*msg += 8;
+				if (parseParamOnOff(msg, 0, &(resolved_command.param.scan_spatial.median))
+						&& parseParamNumber(msg, 0, &number1)
+						&& parseParamOnOff(msg, 1, &(resolved_command.param.scan_spatial.drop))) {
+					/* Check if the value were in bound */
+					if (number1 >= 0 && number1 <= 0xFFF) {
+						resolved_command.event = UC_SetScanSpatial;
+						resolved_command.param.scan_spatial.edge = number1;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
+
+		/* set scan mount */
+		case 'm':
+			if (strncmp(*msg, "mount ", 6) == 0) {
+				/* Check the user parameters */
+				*msg += 6;
+				if (parseParamNumber(msg, 0, &number1) && parseParamNumber(msg, 0, &number2)
+						&& parseParamNumber(msg, 1, &number3)) {
+					/* Check if the value were in bound */
+					if (number1 >= -DP_MOUNT_MAX && number1 <= DP_MOUNT_MAX
+							&& number2 >= -DP_MOUNT_MAX && number2 <= DP_MOUNT_MAX
+							&& number3 >= -1800 && number3 <= 1800) {
+						resolved_command.event = UC_SetScanMount;
+						resolved_command.param.scan_mount.x = number1;
+						resolved_command.param.scan_mount.y = number2;
+						resolved_command.param.scan_mount.rotation = number3;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
+
+		/* set scan pulses, set scan profile */
+		case 'p':
+			if (strncmp(*msg, "profile ", 8) == 0) {
+				/* Check the user parameters */
+				*msg += 8;
+				if (parseParamNumber(msg, 1, &number1)) {
+					/* Check if the value were in bound */
+					if (number1 >= 0 && number1 < DA_PROFILE_MAX) {
+						resolved_command.event = UC_SetScanProfile;
+						resolved_command.param.scan_profile = number1;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			else if (strncmp(*msg, "pulses ", 7) == 0) {
+				/* Check the user parameters */
+				*msg += 7;
+				if (parseParamNumber(msg, 1, &number1)) {
+					/* Check if the value were in bound */
+					if (number1 >= 0 && number1 <= DA_LASERPULSE_MAX) {
+						resolved_command.event = UC_SetScanPulses;
+						resolved_command.param.scan_pulses = number1;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
 			break;
 
 		/* set scan rate */
@@ -503,6 +915,78 @@ void* parseCommandSetScan(char **msg) {
 				success = 1;
 			}
 			break;
+
+		/* set scan tcomp */
+		case 't':
+			if (strncmp(*msg, "tcomp ", 6) == 0) {
+				/* Check the user parameters */
+				*msg += 6;
+				if (parseParamNumber(msg, 0, &number1) && parseParamNumber(msg, 1, &number2)) {
+					/* Check if the value were in bound, the temperature must be a point of the table */
+					number1 -= DP_TCOMP_MIN;
+					if (number1 >= 0 && number1 % DP_TCOMP_STEP == 0 && number1 / DP_TCOMP_STEP < DP_TCOMP_POINTS
+							&& number2 >= -DP_TCOMP_MAX && number2 <= DP_TCOMP_MAX) {
+						resolved_command.event = UC_SetScanTcomp;
+						resolved_command.param.scan_tcomp.index = number1 / DP_TCOMP_STEP;
+						resolved_command.param.scan_tcomp.value = number2;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
+
+		/* set scan zone */
+		case 'z':
+			if (strncmp(*msg, "zone ", 5) == 0) {
+				/* Check the user parameters */
+				*msg += 5;
+				if (parseParamNumber(msg, 0, &number1) && parseParamNumber(msg, 0, &number2)
+						&& parseParamNumber(msg, 0, &number3) && parseParamNumber(msg, 1, &number4)) {
+					/* Check if the value were in bound, a range of 0 disables the zone */
+					if (number1 >= 0 && number1 < DP_ZONE_MAX
+							&& number2 >= DA_AZIMUTH_MIN && number2 < number3 && number3 <= DA_AZIMUTH_MAX
+							&& number4 >= 0 && number4 < 0xFFF) {
+						resolved_command.event = UC_SetScanZone;
+						resolved_command.param.scan_zone.index = number1;
+						resolved_command.param.scan_zone.left = number2;
+						resolved_command.param.scan_zone.right = number3;
+						resolved_command.param.scan_zone.distance = number4;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
+
+		/* set scan walk */
+		case 'w':
+			if (strncmp(*msg, "walk ", 5) == 0) {
+				/* Check the user parameters */
+				*msg += 5;
+				if (parseParamNumber(msg, 1, &number1)) {
+					/* Check if the value were in bound */
+					if (number1 >= 0 && number1 <= DP_WALK_MAX) {
+						resolved_command.event = UC_SetScanWalk;
+						resolved_command.param.scan_walk = number1;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
+			break;
 	}
 
 	/* Check if the command was correct */
@@ -532,7 +1016,7 @@ void* parseCommandSetEngine(char **msg) {
 	int32_t number;
 
 	switch (**msg) {
-		/* set engine sleep */
+		/* set engine sleep, set engine standby */
 		case 's':
 			if (strncmp(*msg, "sleep ", 6) == 0) {
 				/* Check the user parameters */
@@ -551,6 +1035,45 @@ void* parseCommandSetEngine(char **msg) {
 				}
 				success = 1;
 			}
+			else if (strncmp(*msg, "standby ", 8) == 0) {
+				/* Check the user parameters */
+				*msg += 8;
+				if (parseParamOnOff(msg, 1, &(resolved_command.param.engine_standby))) {
+					resolved_command.event = UC_SetEngineStandby;
+					xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+				}
+				success = 1;
+			}
+			break;
+
+		/* set engine idle, set engine ilc */
+		case 'i':
+			if (strncmp(*msg, "ilc ", 4) == 0) {
+				/* Check the user parameters */
+				*msg += 4;
+				if (parseParamOnOff(msg, 1, &(resolved_command.param.engine_ilc))) {
+					resolved_command.event = UC_SetEngineIlc;
+					xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+				}
+				success = 1;
+			}
+			else if (strncmp(*msg, "idle ", 5) == 0) {
+				/* Check the user parameters */
+				*msg += 5;
+				if (parseParamNumber(msg, 1, &number)) {
+					/* Check if the value were in bound */
+					if (number >= 0 && number <= 10) {
+						resolved_command.event = UC_SetEngineIdle;
+						resolved_command.param.engine_idle = number;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+					else {
+						resolved_command.event = ErrUC_ArgOutOfBounds;
+						xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+					}
+				}
+				success = 1;
+			}
 			break;
 	}
 
@@ -601,7 +1124,7 @@ void* parseCommandGet(char **msg) {
 			}
 			break;
 
-		/* get comm */
+		/* get comm, get capture */
 		case 'c':
 			if (strcmp(*msg, "comm") == 0) {
 				/* Send command to the controller */
@@ -610,9 +1133,16 @@ void* parseCommandGet(char **msg) {
 				next_func = NULL;
 				success = 1;
 			}
+			else if (strcmp(*msg, "capture") == 0) {
+				/* Send command to the controller */
+				resolved_command.event = UC_GetCapture;
+				xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+				next_func = NULL;
+				success = 1;
+			}
 			break;
 
-		/* get scan */
+		/* get scan, get stat */
 		case 's':
 			if (strcmp(*msg, "scan") == 0) {
 				/* Send command to the controller */
@@ -621,6 +1151,13 @@ void* parseCommandGet(char **msg) {
 				next_func = NULL;
 				success = 1;
 			}
+			else if (strcmp(*msg, "stat") == 0) {
+				/* Send command to the controller */
+				resolved_command.event = UC_GetStat;
+				xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
+				next_func = NULL;
+				success = 1;
+			}
 			break;
 
 		/* get engine */
@@ -684,6 +1221,10 @@ uint8_t parseParamOnOff(char **msg, uint8_t param_end, uint8_t *param) {
 		xQueueSend(queueEvent, &resolved_command, portMAX_DELAY);
 		success = 0;
 	}
+	else if (success && !param_end) {
+		/* Skip the separator to the next parameter */
+		*msg += 1;
+	}
 
 	return success;
 }
@@ -21,6 +21,7 @@
 #include "queue.h"
 #include "semphr.h"
 #include "timers.h"
+#include "memPoolService.h"
 
 /* Application */
 #include "task_controller.h"
@@ -28,6 +29,7 @@
 #include "task_gatekeeper.h"
 #include "task_comminterp.h"
 #include "task_scanner.h"
+#include "task_dataprocessing.h"
 //#include "task_ee.h"
 
 /* BSP */
@@ -56,11 +58,43 @@ typedef struct {
 	/* User settings */
 	uint8_t comm_echo;			/*!< Enable or disable the command echo. */
 	uint8_t comm_respmsg;		/*!< Enable or disable the response message. */
-	int16_t scan_bndry_left;	/*!< Configured scan area boundary left. [tenth degree] */
-	int16_t scan_bndry_right;	/*!< Configured scan area boundary right. [tenth degree] */
-	int16_t scan_step;			/*!< Configures step size between two measurement points. [tenth degree] */
-	uint8_t scan_rate;			/*!< Configured update rate of the hole room map. [turns per second] */
+	uint8_t comm_intensity;		/*!< Enable or disable the intensity in the data stream. */
+	uint8_t comm_frame;			/*!< Enable or disable the frames in the data stream. */
+	uint8_t comm_delta_keyframe;	/*!< Frames between two keyframes of the delta encoding, 0 if disabled. */
+	uint16_t comm_delta_threshold;	/*!< Distance change of a bin, which is sent by the delta encoding. [mm] */
+	uint8_t comm_cartesian;		/*!< Enable or disable the Cartesian coordinates in the data stream. */
+	uint8_t comm_lines_mode;	/*!< Line segments off, alongside or instead of the points. */
+	uint16_t comm_lines_tolerance;	/*!< Maximum distance of a point to its line segment. [mm] */
+	uint8_t comm_lines_points;	/*!< Fewest points of a line segment. */
+	uint8_t comm_background_mode;	/*!< All points, the foreground points or the blobs. */
+	uint8_t comm_background_turns;	/*!< Number of turns to learn the background. */
+	uint16_t comm_background_tolerance;	/*!< Distance of a foreground point to the background. [mm] */
+	uint16_t comm_tracker_gate;	/*!< Largest distance of an object to its predicted track, 0 if disabled. [mm] */
+	uint8_t comm_tracker_misses;	/*!< Scans a track is predicted without an object. */
+	uint8_t comm_raw;			/*!< Enable or disable the raw TDC data in the data stream. */
+	uint8_t comm_qos;			/*!< Enable or disable the governor of the data stream. */
+	uint8_t comm_marker;		/*!< Enable or disable the scan start marker in the data stream. */
+	scanconfig_t scan[DA_PROFILE_MAX];	/*!< Configured scan sectors and rate of each profile, 0 laser pulses for the maximum. */
+	uint8_t scan_profile;		/*!< Selected scan profile to configure and to use. */
+	uint8_t scan_alternate;		/*!< Alternate the scan profiles each turn. */
+	uint16_t scan_gate_min;		/*!< Near limit of the range gate, 0 if disabled. [mm] */
+	uint16_t scan_gate_max;		/*!< Far limit of the range gate, 0 if disabled. [mm] */
+	uint8_t scan_walk;			/*!< Walk error correction of a point without intensity, 0 if disabled. [mm] */
+	uint8_t scan_calib;			/*!< Number of turns between two calibrations. */
+	int8_t scan_tcomp[DP_TCOMP_POINTS];	/*!< Temperature correction table, starting at DP_TCOMP_MIN. [mm] */
+	uint8_t scan_spatial_median;	/*!< Enable or disable the median of the neighbourhood. */
+	uint16_t scan_spatial_edge;	/*!< Distance step of a mixed pixel, 0 if disabled. [mm] */
+	uint8_t scan_spatial_drop;	/*!< Drop or flag the rejected points. */
+	int16_t scan_mount_x;		/*!< Offset of the sensor in front direction. [mm] */
+	int16_t scan_mount_y;		/*!< Offset of the sensor in left direction. [mm] */
+	int16_t scan_mount_rotation;	/*!< Azimuth of the sensor front in the vehicle frame. [tenth degree] */
+	zone_t scan_zone[DP_ZONE_MAX];	/*!< Protective zones. */
+	uint8_t scan_filter_shift;	/*!< Filter weight of the new distance is 1/2^shift, 0 if disabled. */
+	uint16_t scan_filter_jump;	/*!< Distance change, which resets the temporal filter. [mm] */
 	uint16_t engine_sleep;		/*!< Configured time delay before the engine is suspended in CMD mode. [ms] */
+	uint8_t engine_standby;		/*!< Keep the engine turning in CMD mode. */
+	uint8_t engine_idle;		/*!< Configured standby speed, 0 for the last scan rate. [turns per second] */
+	uint8_t engine_ilc;			/*!< Enable or disable the speed ripple feed-forward. */
 
 	/* System settings */
 	enum {
@@ -68,6 +102,7 @@ typedef struct {
 		MODE_DATA				/*!< Mode DATA. */
 	} state;					/*!< System mode. */
 	readcommand_t readcommand;	/*!< The read command value for the command interpreter task. */
+	scanplan_t scan_plan[DA_PROFILE_MAX];	/*!< Timing plan of each scan profile. */
 } system_t;
 
 
@@ -81,6 +116,10 @@ void taskController(void* pvParameters);
 void sendMessage(char msg_typw, const char* msg);
 void triggerMalfunctionLed(void);
 void stopDataAcquisition(void);
+void setScanConfig(const scanconfig_t *config);
+void setScanGate(uint16_t gate_min, uint16_t gate_max);
+void getScanProfiles(scanprofiles_t *scan);
+void updateScanProfiles(void);
 
 
 /*
@@ -170,8 +209,31 @@ void taskController(void* pvParameters) {
 	event_t event;
 	char str_buffer[64];
 	dataacquisition_t data_acquisition_config;
+	scanconfig_t scan_config;
+	dataprocessing_t data_processing_config;
+	uint8_t i;
 	uint16_t tdc_hits;
 	uint8_t hits_error;
+	uint16_t ripple_initial, ripple_current;
+	uint32_t isr_azimuth, isr_sequence, isr_hit;
+	uint32_t bus_spi, bus_isr;
+	uint32_t filter_temporal, filter_spatial;
+	uint32_t hit_ratio, valid_ratio;
+	uint32_t hit_bins[DP_HITS_CLASSES];
+	const frame_t *frame;
+	uint32_t frame_overruns;
+	uint32_t lines_count, lines_us, lines_overruns;
+	uint32_t zone_events, zone_latency, zone_dropped;
+	uint32_t output_suppressed, output_ns;
+	uint32_t tracker_objects, tracker_us, tracker_dropped, tracker_overruns;
+	uint32_t capture_frames, capture_bytes;
+	uint32_t raw_records, raw_dropped;
+	uint8_t qos_level, qos_pressure;
+	uint32_t qos_decimated, qos_dropped, qos_skipped, qos_reduced;
+	uint32_t faults[DA_FAULTS];
+	messageblock_t capture_block;
+	volatile uint8_t capture_busy;
+	zone_t *zone;
 
 	/* Sends the welcome text */
 	event.event = Sys_Welcome;
@@ -194,11 +256,52 @@ void taskController(void* pvParameters) {
 				/* Set the default system states and configurations */
 				g_systemState.comm_echo = 1;
 				g_systemState.comm_respmsg = 1;
-				g_systemState.scan_bndry_left = DA_AZIMUTH_MIN;
-				g_systemState.scan_bndry_right = DA_AZIMUTH_MAX;
-				g_systemState.scan_step = DA_AZIMUTH_RES;
-				g_systemState.scan_rate = DA_DEF_SCANRATE;
+				g_systemState.comm_intensity = 0;
+				g_systemState.comm_frame = 0;
+				g_systemState.comm_delta_keyframe = 0;
+				g_systemState.comm_delta_threshold = 0;
+				g_systemState.comm_cartesian = 0;
+				g_systemState.comm_lines_mode = DP_LINES_OFF;
+				g_systemState.comm_lines_tolerance = DP_LINES_TOLERANCE_DEF;
+				g_systemState.comm_lines_points = DP_LINES_POINTS_DEF;
+				g_systemState.comm_background_mode = DP_BACKGROUND_OFF;
+				g_systemState.comm_background_turns = DP_BACKGROUND_TURNS_DEF;
+				g_systemState.comm_background_tolerance = DP_BACKGROUND_TOLERANCE_DEF;
+				g_systemState.comm_tracker_gate = 0;
+				g_systemState.comm_tracker_misses = DP_TRACKER_MISSES_DEF;
+				g_systemState.comm_raw = 0;
+				g_systemState.comm_qos = 1;
+				g_systemState.comm_marker = 0;
+				memset(g_systemState.scan, 0, sizeof(g_systemState.scan));
+				for (i=0; i<DA_PROFILE_MAX; i++) {
+					g_systemState.scan[i].sector[0].left = DA_AZIMUTH_MIN;
+					g_systemState.scan[i].sector[0].right = DA_AZIMUTH_MAX;
+					g_systemState.scan[i].sector[0].step = DA_AZIMUTH_RES;
+					g_systemState.scan[i].sector[0].pulses = DA_DEF_LASERPULSE;
+					g_systemState.scan[i].rate = DA_DEF_SCANRATE;
+					g_systemState.scan[i].binning = 1;
+					taskDataAcquisitionPlan(&g_systemState.scan[i], &g_systemState.scan_plan[i]);
+				}
+				g_systemState.scan_profile = 0;
+				g_systemState.scan_alternate = 0;
+				g_systemState.scan_gate_min = 0;
+				g_systemState.scan_gate_max = 0;
+				g_systemState.scan_walk = 0;
+				g_systemState.scan_calib = 1;
+				memset(g_systemState.scan_tcomp, 0, sizeof(g_systemState.scan_tcomp));
+				g_systemState.scan_filter_shift = 0;
+				g_systemState.scan_filter_jump = DP_FILTER_JUMP_DEF;
+				g_systemState.scan_spatial_median = 0;
+				g_systemState.scan_spatial_edge = 0;
+				g_systemState.scan_spatial_drop = 0;
+				g_systemState.scan_mount_x = 0;
+				g_systemState.scan_mount_y = 0;
+				g_systemState.scan_mount_rotation = 0;
+				memset(g_systemState.scan_zone, 0, sizeof(g_systemState.scan_zone));
 				g_systemState.engine_sleep = 0;
+				g_systemState.engine_standby = 0;
+				g_systemState.engine_idle = 0;
+				g_systemState.engine_ilc = 1;
 				g_systemState.state = MODE_CMD;
 				g_systemState.readcommand = 1;
 
@@ -218,12 +321,59 @@ void taskController(void* pvParameters) {
 				sendMessage(MSG_TYPE_STATE, "By Kevin Gerber, Marcel Baertschi");
 				break;
 
+			/* The burst capture is complete */
+			case Sys_CaptureDone:
+				if (g_systemState.state == MODE_DATA) {
+					/* Stop the data acquisition */
+					data_acquisition_config.state = DATA_ACQUISITION_DISABLE;
+					data_acquisition_config.param.engine.sleep = g_systemState.engine_sleep;
+					data_acquisition_config.param.engine.rate = 0;
+					if (g_systemState.engine_standby) {
+						/* Keep the mirror turning */
+						data_acquisition_config.param.engine.rate = g_systemState.engine_idle ?
+								g_systemState.engine_idle : g_systemState.scan[0].rate;
+					}
+					xQueueSend(queueDataAcquisition, &data_acquisition_config, portMAX_DELAY);
+
+					/* Change the state */
+					g_systemState.state = MODE_CMD;
+					g_systemState.readcommand = g_systemState.comm_echo;
+
+					/* Reset the LED */
+					bsp_LedSetOff(LED_LASER_OPERATION);
+
+					/* Send the new state */
+					sprintf(str_buffer, "capture done %d", event.param.capture);
+					sendMessage(MSG_TYPE_STATE, str_buffer);
+					sendMessage(MSG_TYPE_STATE, "cmd");
+				}
+				break;
+
+			/* A scan configuration of the data mode is taken over */
+			case Sys_ScanUpdate:
+				if (g_systemState.state == MODE_DATA) {
+					sprintf(str_buffer, "scan update %d", event.param.scan_id);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+				}
+				break;
+
 			/* Change into the command mode */
 			case UC_Cmd:
 				if (g_systemState.state == MODE_DATA) {
+					/* Stop a burst capture, the captured scans are kept */
+					data_processing_config.config = DATA_PROCESSING_CAPTURE;
+					data_processing_config.param.capture = 0;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
 					/* Stop the data acquisition */
 					data_acquisition_config.state = DATA_ACQUISITION_DISABLE;
-					data_acquisition_config.param.engine_sleep = g_systemState.engine_sleep;
+					data_acquisition_config.param.engine.sleep = g_systemState.engine_sleep;
+					data_acquisition_config.param.engine.rate = 0;
+					if (g_systemState.engine_standby) {
+						/* Keep the mirror turning */
+						data_acquisition_config.param.engine.rate = g_systemState.engine_idle ?
+								g_systemState.engine_idle : g_systemState.scan[0].rate;
+					}
 					xQueueSend(queueDataAcquisition, &data_acquisition_config, portMAX_DELAY);
 
 					/* Change the state */
@@ -241,6 +391,15 @@ void taskController(void* pvParameters) {
 				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
 				break;
 
+			/* Starts the data acquisition and captures the scans into the RAM */
+			case UC_Capture:
+				if (g_systemState.state == MODE_CMD) {
+					data_processing_config.config = DATA_PROCESSING_CAPTURE;
+					data_processing_config.param.capture = event.param.capture;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+				}
+				/* no break: the data acquisition starts like in the data mode */
+
 			/* Change into the data mode and starts the data acquisition */
 			case UC_Data:
 				if (g_systemState.state == MODE_CMD) {
@@ -250,10 +409,7 @@ void taskController(void* pvParameters) {
 
 					/* Starts the data acquisition */
 					data_acquisition_config.state = DATA_ACQUISITION_ENABLE;
-					data_acquisition_config.param.scan.bndry_left = g_systemState.scan_bndry_left;
-					data_acquisition_config.param.scan.bndry_right = g_systemState.scan_bndry_right;
-					data_acquisition_config.param.scan.step = g_systemState.scan_step;
-					data_acquisition_config.param.scan.rate = g_systemState.scan_rate;
+					getScanProfiles(&data_acquisition_config.param.scan);
 					xQueueSend(queueDataAcquisition, &data_acquisition_config, portMAX_DELAY);
 
 					/* Set the LED */
@@ -313,10 +469,97 @@ void taskController(void* pvParameters) {
 
 			/* Configure the scan area boundary */
 			case UC_SetScanBndry:
+				/* Change the system state */
+				scan_config = g_systemState.scan[g_systemState.scan_profile];
+				scan_config.sector[0].left = event.param.azimuth_bndry.left;
+				scan_config.sector[0].right = event.param.azimuth_bndry.right;
+				setScanConfig(&scan_config);
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the step size between two measurement points */
+			case UC_SetScanStep:
+				/* Change the system state */
+				scan_config = g_systemState.scan[g_systemState.scan_profile];
+				scan_config.sector[0].step = event.param.azimuth_step;
+				setScanConfig(&scan_config);
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the update rate of the hole room map */
+			case UC_SetScanRate:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					scan_config = g_systemState.scan[g_systemState.scan_profile];
+					scan_config.rate = event.param.scan_rate;
+					setScanConfig(&scan_config);
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the number of laser pulses each measurement point */
+			case UC_SetScanPulses:
+				/* Change the system state */
+				scan_config = g_systemState.scan[g_systemState.scan_profile];
+				scan_config.sector[0].pulses = event.param.scan_pulses;
+				setScanConfig(&scan_config);
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure an additional scan sector */
+			case UC_SetScanSector:
+				/* Change the system state */
+				scan_config = g_systemState.scan[g_systemState.scan_profile];
+				scan_config.sector[event.param.scan_sector.id].left = event.param.scan_sector.left;
+				scan_config.sector[event.param.scan_sector.id].right = event.param.scan_sector.right;
+				scan_config.sector[event.param.scan_sector.id].step = event.param.scan_sector.step;
+				scan_config.sector[event.param.scan_sector.id].pulses = event.param.scan_sector.pulses;
+				setScanConfig(&scan_config);
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the target arc length of the range adaptive sampling */
+			case UC_SetScanArc:
+				/* Change the system state */
+				g_systemState.scan[g_systemState.scan_profile].arc = event.param.scan_arc;
+
+				/* Send the acknowledge to the user */
+				sendMessage(MSG_TYPE_RSP, "00 aok");
+				updateScanProfiles();
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the number of points pooled into one point */
+			case UC_SetScanBinning:
+				/* Change the system state */
+				scan_config = g_systemState.scan[g_systemState.scan_profile];
+				scan_config.binning = event.param.scan_binning;
+				setScanConfig(&scan_config);
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Enable/disable the intensity in the data stream */
+			case UC_SetCommIntensity:
 				if (g_systemState.state == MODE_CMD) {
 					/* Change the system state */
-					g_systemState.scan_bndry_left = event.param.azimuth_bndry.left;
-					g_systemState.scan_bndry_right = event.param.azimuth_bndry.right;
+					g_systemState.comm_intensity = event.param.intensity;
+					data_processing_config.config = DATA_PROCESSING_INTENSITY;
+					data_processing_config.param.intensity = event.param.intensity;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
 
 					/* Send the acknowledge to the user */
 					sendMessage(MSG_TYPE_RSP, "00 aok");
@@ -326,11 +569,14 @@ void taskController(void* pvParameters) {
 				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
 				break;
 
-			/* Configure the step size between two measurement points */
-			case UC_SetScanStep:
+			/* Enable/disable the raw TDC data instead of the points in the data stream */
+			case UC_SetCommRaw:
 				if (g_systemState.state == MODE_CMD) {
 					/* Change the system state */
-					g_systemState.scan_step = event.param.azimuth_step;
+					g_systemState.comm_raw = event.param.raw;
+					data_processing_config.config = DATA_PROCESSING_RAW;
+					data_processing_config.param.raw = event.param.raw;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
 
 					/* Send the acknowledge to the user */
 					sendMessage(MSG_TYPE_RSP, "00 aok");
@@ -340,11 +586,31 @@ void taskController(void* pvParameters) {
 				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
 				break;
 
-			/* Configure the update rate of the hole room map */
-			case UC_SetScanRate:
+			/* Enable/disable the governor of the data stream */
+			case UC_SetCommQos:
 				if (g_systemState.state == MODE_CMD) {
 					/* Change the system state */
-					g_systemState.scan_rate = event.param.scan_rate;
+					g_systemState.comm_qos = event.param.qos;
+					data_processing_config.config = DATA_PROCESSING_QOS;
+					data_processing_config.param.qos = event.param.qos;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Enable/disable the scan start marker in the data stream */
+			case UC_SetCommMarker:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state, alternating profiles always have the marker */
+					g_systemState.comm_marker = event.param.marker;
+					data_processing_config.config = DATA_PROCESSING_MARKER;
+					data_processing_config.param.marker = g_systemState.comm_marker || g_systemState.scan_alternate;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
 
 					/* Send the acknowledge to the user */
 					sendMessage(MSG_TYPE_RSP, "00 aok");
@@ -354,6 +620,292 @@ void taskController(void* pvParameters) {
 				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
 				break;
 
+			/* Enable/disable the frames in the data stream */
+			case UC_SetCommFrame:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.comm_frame = event.param.frame;
+					data_processing_config.config = DATA_PROCESSING_FRAME;
+					data_processing_config.param.frame = event.param.frame;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the delta encoding of the frames */
+			case UC_SetCommDelta:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.comm_delta_keyframe = event.param.delta.keyframe;
+					g_systemState.comm_delta_threshold = event.param.delta.threshold;
+					data_processing_config.config = DATA_PROCESSING_DELTA;
+					data_processing_config.param.delta.keyframe = event.param.delta.keyframe;
+					data_processing_config.param.delta.threshold = event.param.delta.threshold;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Enable/disable the Cartesian coordinates in the data stream */
+			case UC_SetCommCartesian:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.comm_cartesian = event.param.cartesian;
+					data_processing_config.config = DATA_PROCESSING_CARTESIAN;
+					data_processing_config.param.cartesian = event.param.cartesian;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the line segments in the data stream */
+			case UC_SetCommLines:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.comm_lines_mode = event.param.lines.mode;
+					g_systemState.comm_lines_tolerance = event.param.lines.tolerance;
+					g_systemState.comm_lines_points = event.param.lines.points;
+					data_processing_config.config = DATA_PROCESSING_LINES;
+					data_processing_config.param.lines.mode = event.param.lines.mode;
+					data_processing_config.param.lines.tolerance = event.param.lines.tolerance;
+					data_processing_config.param.lines.points = event.param.lines.points;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the background change detection */
+			case UC_SetCommBackground:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.comm_background_mode = event.param.background.mode;
+					g_systemState.comm_background_turns = event.param.background.turns;
+					g_systemState.comm_background_tolerance = event.param.background.tolerance;
+					data_processing_config.config = DATA_PROCESSING_BACKGROUND;
+					data_processing_config.param.background.mode = event.param.background.mode;
+					data_processing_config.param.background.turns = event.param.background.turns;
+					data_processing_config.param.background.tolerance = event.param.background.tolerance;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the object tracker in the data stream */
+			case UC_SetCommTracker:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.comm_tracker_gate = event.param.tracker.gate;
+					g_systemState.comm_tracker_misses = event.param.tracker.misses;
+					data_processing_config.config = DATA_PROCESSING_TRACKER;
+					data_processing_config.param.tracker.gate = event.param.tracker.gate;
+					data_processing_config.param.tracker.misses = event.param.tracker.misses;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure a protective zone */
+			case UC_SetScanZone:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					zone = &g_systemState.scan_zone[event.param.scan_zone.index];
+					zone->left = event.param.scan_zone.left;
+					zone->right = event.param.scan_zone.right;
+					zone->distance = event.param.scan_zone.distance;
+					data_processing_config.config = DATA_PROCESSING_ZONE;
+					data_processing_config.param.zone.index = event.param.scan_zone.index;
+					data_processing_config.param.zone.zone = *zone;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the mounting position of the sensor */
+			case UC_SetScanMount:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.scan_mount_x = event.param.scan_mount.x;
+					g_systemState.scan_mount_y = event.param.scan_mount.y;
+					g_systemState.scan_mount_rotation = event.param.scan_mount.rotation;
+					data_processing_config.config = DATA_PROCESSING_MOUNT;
+					data_processing_config.param.mount.x = event.param.scan_mount.x;
+					data_processing_config.param.mount.y = event.param.scan_mount.y;
+					data_processing_config.param.mount.rotation = event.param.scan_mount.rotation;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the walk error correction */
+			case UC_SetScanWalk:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.scan_walk = event.param.scan_walk;
+					data_processing_config.config = DATA_PROCESSING_WALK;
+					data_processing_config.param.walk = event.param.scan_walk;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the number of turns between two calibrations */
+			case UC_SetScanCalib:
+				/* Change the system state */
+				g_systemState.scan_calib = event.param.scan_calib;
+
+				/* Send the acknowledge to the user */
+				sendMessage(MSG_TYPE_RSP, "00 aok");
+				updateScanProfiles();
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure a point of the temperature correction table */
+			case UC_SetScanTcomp:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.scan_tcomp[event.param.scan_tcomp.index] = event.param.scan_tcomp.value;
+					data_processing_config.config = DATA_PROCESSING_TCOMP;
+					data_processing_config.param.tcomp.index = event.param.scan_tcomp.index;
+					data_processing_config.param.tcomp.value = event.param.scan_tcomp.value;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the temporal filter */
+			case UC_SetScanFilter:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.scan_filter_shift = event.param.scan_filter.shift;
+					g_systemState.scan_filter_jump = event.param.scan_filter.jump;
+					data_processing_config.config = DATA_PROCESSING_FILTER;
+					data_processing_config.param.filter.shift = event.param.scan_filter.shift;
+					data_processing_config.param.filter.jump = event.param.scan_filter.jump;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the spatial filter */
+			case UC_SetScanSpatial:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.scan_spatial_median = event.param.scan_spatial.median;
+					g_systemState.scan_spatial_edge = event.param.scan_spatial.edge;
+					g_systemState.scan_spatial_drop = event.param.scan_spatial.drop;
+					data_processing_config.config = DATA_PROCESSING_SPATIAL;
+					data_processing_config.param.spatial.median = event.param.scan_spatial.median;
+					data_processing_config.param.spatial.edge = event.param.scan_spatial.edge;
+					data_processing_config.param.spatial.drop = event.param.scan_spatial.drop;
+					xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Configure the range gate of the hits */
+			case UC_SetScanGate:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					setScanGate(event.param.scan_gate.min, event.param.scan_gate.max);
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Select the scan profile to configure and to use */
+			case UC_SetScanProfile:
+				/* Change the system state */
+				g_systemState.scan_profile = event.param.scan_profile;
+
+				/* Send the acknowledge to the user */
+				sendMessage(MSG_TYPE_RSP, "00 aok");
+				updateScanProfiles();
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Enable/disable the alternating scan profiles */
+			case UC_SetScanAlternate:
+				/* Change the system state */
+				g_systemState.scan_alternate = event.param.scan_alternate;
+
+				/* The host tells the alternating profiles apart by the scan start marker */
+				data_processing_config.config = DATA_PROCESSING_MARKER;
+				data_processing_config.param.marker = g_systemState.comm_marker || g_systemState.scan_alternate;
+				xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+				/* Send the acknowledge to the user */
+				sendMessage(MSG_TYPE_RSP, "00 aok");
+				updateScanProfiles();
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
 			/* Sets the time delay before the engine is suspended */
 			case UC_SetEngineSleep:
 				if (g_systemState.state == MODE_CMD) {
@@ -368,6 +920,49 @@ void taskController(void* pvParameters) {
 				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
 				break;
 
+			/* Enable/disable the engine standby in the command mode */
+			case UC_SetEngineStandby:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.engine_standby = event.param.engine_standby;
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Sets the engine standby speed in the command mode */
+			case UC_SetEngineIdle:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.engine_idle = event.param.engine_idle;
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Enable/disable the speed ripple feed-forward */
+			case UC_SetEngineIlc:
+				if (g_systemState.state == MODE_CMD) {
+					/* Change the system state */
+					g_systemState.engine_ilc = event.param.engine_ilc;
+					taskScannerSetIlc(event.param.engine_ilc);
+
+					/* Send the acknowledge to the user */
+					sendMessage(MSG_TYPE_RSP, "00 aok");
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
 			/* Get all configured parameters */
 			case UC_GetAll:
 				/* Execute all get cases */
@@ -396,6 +991,49 @@ void taskController(void* pvParameters) {
 					/* Print communication response message */
 					sprintf(str_buffer, "comm respmsg %s", g_systemState.comm_respmsg ? "on" : "off");
 					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print communication intensity */
+					sprintf(str_buffer, "comm intensity %s", g_systemState.comm_intensity ? "on" : "off");
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print communication frame */
+					sprintf(str_buffer, "comm frame %s", g_systemState.comm_frame ? "on" : "off");
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print communication raw TDC data */
+					sprintf(str_buffer, "comm raw %s", g_systemState.comm_raw ? "on" : "off");
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print communication governor */
+					sprintf(str_buffer, "comm qos %s", g_systemState.comm_qos ? "on" : "off");
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print communication scan start marker */
+					sprintf(str_buffer, "comm marker %s", g_systemState.comm_marker ? "on" : "off");
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print communication delta encoding */
+					sprintf(str_buffer, "comm delta %d %d", g_systemState.comm_delta_keyframe, g_systemState.comm_delta_threshold);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print communication Cartesian coordinates */
+					sprintf(str_buffer, "comm cartesian %s", g_systemState.comm_cartesian ? "on" : "off");
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print communication line segments */
+					sprintf(str_buffer, "comm lines %d %d %d", g_systemState.comm_lines_mode,
+							g_systemState.comm_lines_tolerance, g_systemState.comm_lines_points);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print communication background change detection */
+					sprintf(str_buffer, "comm background %d %d %d", g_systemState.comm_background_mode,
+							g_systemState.comm_background_turns, g_systemState.comm_background_tolerance);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print communication object tracker */
+					sprintf(str_buffer, "comm tracker %d %d", g_systemState.comm_tracker_gate,
+							g_systemState.comm_tracker_misses);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
 				}
 
 				/* Execute all get cases */
@@ -408,16 +1046,88 @@ void taskController(void* pvParameters) {
 			/* Get the scan configurations */
 			case UC_GetScan:
 				if (g_systemState.state == MODE_CMD) {
+					/* Print scan profile */
+					sprintf(str_buffer, "scan profile %d", g_systemState.scan_profile);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print scan alternate */
+					sprintf(str_buffer, "scan alternate %s", g_systemState.scan_alternate ? "on" : "off");
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
 					/* Print scan boundary */
-					sprintf(str_buffer, "scan bndry %d %d", g_systemState.scan_bndry_left, g_systemState.scan_bndry_right);
+					sprintf(str_buffer, "scan bndry %d %d", g_systemState.scan[g_systemState.scan_profile].sector[0].left, g_systemState.scan[g_systemState.scan_profile].sector[0].right);
 					sendMessage(MSG_TYPE_CONF, str_buffer);
 
 					/* Print scan step */
-					sprintf(str_buffer, "scan step %d", g_systemState.scan_step);
+					sprintf(str_buffer, "scan step %d", g_systemState.scan[g_systemState.scan_profile].sector[0].step);
 					sendMessage(MSG_TYPE_CONF, str_buffer);
 
 					/* Print scan rate */
-					sprintf(str_buffer, "scan rate %d", g_systemState.scan_rate);
+					sprintf(str_buffer, "scan rate %d", g_systemState.scan[g_systemState.scan_profile].rate);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print scan pulses */
+					sprintf(str_buffer, "scan pulses %d", g_systemState.scan[g_systemState.scan_profile].sector[0].pulses);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print scan arc */
+					sprintf(str_buffer, "scan arc %d", g_systemState.scan[g_systemState.scan_profile].arc);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print scan binning */
+					sprintf(str_buffer, "scan binning %d", g_systemState.scan[g_systemState.scan_profile].binning);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print scan gate */
+					sprintf(str_buffer, "scan gate %d %d", g_systemState.scan_gate_min, g_systemState.scan_gate_max);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print scan walk */
+					sprintf(str_buffer, "scan walk %d", g_systemState.scan_walk);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print scan filter */
+					sprintf(str_buffer, "scan filter %d %d", g_systemState.scan_filter_shift, g_systemState.scan_filter_jump);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print scan spatial */
+					sprintf(str_buffer, "scan spatial %s %d %s", g_systemState.scan_spatial_median ? "on" : "off",
+							g_systemState.scan_spatial_edge, g_systemState.scan_spatial_drop ? "on" : "off");
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print scan mount */
+					sprintf(str_buffer, "scan mount %d %d %d", g_systemState.scan_mount_x,
+							g_systemState.scan_mount_y, g_systemState.scan_mount_rotation);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print scan calib */
+					sprintf(str_buffer, "scan calib %d", g_systemState.scan_calib);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the temperature correction table */
+					for (i=0; i<DP_TCOMP_POINTS; i++) {
+						sprintf(str_buffer, "scan tcomp %d %d", DP_TCOMP_MIN + i * DP_TCOMP_STEP, g_systemState.scan_tcomp[i]);
+						sendMessage(MSG_TYPE_CONF, str_buffer);
+					}
+
+					/* Print the protective zones */
+					for (i=0; i<DP_ZONE_MAX; i++) {
+						sprintf(str_buffer, "scan zone %d %d %d %d", i, g_systemState.scan_zone[i].left,
+								g_systemState.scan_zone[i].right, g_systemState.scan_zone[i].distance);
+						sendMessage(MSG_TYPE_CONF, str_buffer);
+					}
+
+					/* Print the additional scan sectors */
+					for (i=1; i<DA_SECTOR_MAX; i++) {
+						sprintf(str_buffer, "scan sector %d %d %d %d %d", i, g_systemState.scan[g_systemState.scan_profile].sector[i].left,
+								g_systemState.scan[g_systemState.scan_profile].sector[i].right, g_systemState.scan[g_systemState.scan_profile].sector[i].step,
+								g_systemState.scan[g_systemState.scan_profile].sector[i].pulses);
+						sendMessage(MSG_TYPE_CONF, str_buffer);
+					}
+
+					/* Print the timing plan */
+					sprintf(str_buffer, "scan plan %u %u", (unsigned int) g_systemState.scan_plan[g_systemState.scan_profile].sector[0].pulses,
+							(unsigned int) g_systemState.scan_plan[g_systemState.scan_profile].points_per_second);
 					sendMessage(MSG_TYPE_CONF, str_buffer);
 				}
 
@@ -434,6 +1144,172 @@ void taskController(void* pvParameters) {
 					/* Print engine sleep */
 					sprintf(str_buffer, "engien sleep %d", g_systemState.engine_sleep);
 					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print engine standby */
+					sprintf(str_buffer, "engine standby %s", g_systemState.engine_standby ? "on" : "off");
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print engine standby speed */
+					sprintf(str_buffer, "engine idle %d", g_systemState.engine_idle);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print engine speed ripple feed-forward */
+					sprintf(str_buffer, "engine ilc %s", g_systemState.engine_ilc ? "on" : "off");
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Get the runtime statistics */
+			case UC_GetStat:
+				if (g_systemState.state == MODE_CMD) {
+					/* Print the speed variation within a turn [tenth percent] */
+					taskScannerGetRipple(&ripple_initial, &ripple_current);
+					sprintf(str_buffer, "stat ripple %u %u", ripple_initial, ripple_current);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the measured interrupt costs each point [ns] */
+					taskDataAcquisitionIsrCost(&isr_azimuth, &isr_sequence, &isr_hit);
+					sprintf(str_buffer, "stat isr %u %u", (unsigned int) isr_azimuth, (unsigned int) isr_sequence);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+					sprintf(str_buffer, "stat isr hit %u", (unsigned int) isr_hit);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the bus load each point [tenth] */
+					taskDataAcquisitionBusLoad(&bus_spi, &bus_isr);
+					sprintf(str_buffer, "stat bus %u %u", (unsigned int) bus_spi, (unsigned int) bus_isr);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the temperature of the TDC [tenth degree Celsius] */
+					sprintf(str_buffer, "stat temp %d", taskDataProcessingGetTemperature());
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the costs of the filters each point [ns] */
+					taskDataProcessingFilterCost(&filter_temporal, &filter_spatial);
+					sprintf(str_buffer, "stat filter %u %u", (unsigned int) filter_temporal, (unsigned int) filter_spatial);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the hit statistics of the points [per mill] */
+					taskDataProcessingGetHits(&hit_ratio, &valid_ratio);
+					sprintf(str_buffer, "stat hits %u %u", (unsigned int) hit_ratio, (unsigned int) valid_ratio);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the bins in each quarter of the received hits [per mill] */
+					taskDataProcessingGetBins(hit_bins);
+					sprintf(str_buffer, "stat bins %u %u %u %u", (unsigned int) hit_bins[0], (unsigned int) hit_bins[1],
+							(unsigned int) hit_bins[2], (unsigned int) hit_bins[3]);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the suppressed points [per mill] and the output time each point [ns] */
+					taskDataProcessingOutputStats(&output_suppressed, &output_ns);
+					sprintf(str_buffer, "stat output %u %u", (unsigned int) output_suppressed, (unsigned int) output_ns);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the sent and the dropped raw records */
+					taskDataProcessingRawStats(&raw_records, &raw_dropped);
+					sprintf(str_buffer, "stat raw %u %u", (unsigned int) raw_records, (unsigned int) raw_dropped);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the governor level and pressure [percent], and the points with halved laser pulses */
+					taskDataProcessingQosStats(&qos_level, &qos_pressure, &qos_decimated, &qos_dropped);
+					taskDataAcquisitionQosStats(&qos_skipped, &qos_reduced);
+					sprintf(str_buffer, "stat qos %u %u %u", (unsigned int) qos_level, (unsigned int) qos_pressure,
+							(unsigned int) qos_reduced);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the points left out by the governor: decimated and skipped bins */
+					sprintf(str_buffer, "stat skip %u %u", (unsigned int) qos_decimated, (unsigned int) qos_skipped);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the dropped points: full data queue and serial interface */
+					sprintf(str_buffer, "stat drop %u %u", (unsigned int) qos_dropped, (unsigned int) taskGatekeeperDataDropped());
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the faults of the points: memory pool, raw data pointer and timing */
+					taskDataAcquisitionFaults(faults);
+					sprintf(str_buffer, "stat fault %u %u", (unsigned int) faults[DA_FAULT_POOL],
+							(unsigned int) faults[DA_FAULT_POINTER]);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+					sprintf(str_buffer, "stat fault timing %u", (unsigned int) faults[DA_FAULT_TIMING]);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the tracked objects of the latest scan and the worst tracking time each scan [us] */
+					taskDataProcessingTrackerStats(&tracker_objects, &tracker_us, &tracker_dropped, &tracker_overruns);
+					sprintf(str_buffer, "stat tracker %u %u", (unsigned int) tracker_objects, (unsigned int) tracker_us);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the dropped objects and scans of the tracker */
+					sprintf(str_buffer, "stat tracker drop %u %u", (unsigned int) tracker_dropped, (unsigned int) tracker_overruns);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the zone intrusions and the worst detection latency [us] */
+					taskDataProcessingZoneStats(&zone_events, &zone_latency, &zone_dropped);
+					sprintf(str_buffer, "stat zone %u %u", (unsigned int) zone_events, (unsigned int) zone_latency);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the alarm messages lost by a full alarm queue */
+					sprintf(str_buffer, "stat zone drop %u", (unsigned int) zone_dropped);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the line segments of the latest scan, the worst extraction time each scan [us] and the dropped scans */
+					taskDataProcessingLineStats(&lines_count, &lines_us, &lines_overruns);
+					sprintf(str_buffer, "stat lines %u %u %u", (unsigned int) lines_count,
+							(unsigned int) lines_us, (unsigned int) lines_overruns);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the latest complete frame and the dropped frames */
+					frame = taskDataProcessingLatestFrame(&frame_overruns);
+					if (frame != NULL) {
+						sprintf(str_buffer, "stat frame %u %u %u", (unsigned int) frame->scan_id,
+								(unsigned int) frame->points, (unsigned int) (frame->end - frame->start));
+					}
+					else {
+						strcpy(str_buffer, "stat frame - - -");
+					}
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+					sprintf(str_buffer, "stat frame drop %u", (unsigned int) frame_overruns);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the free heap and the lowest free heap since the start [bytes] */
+					sprintf(str_buffer, "stat heap %u %u", (unsigned int) xPortGetFreeHeapSize(),
+							(unsigned int) xPortGetMinimumEverFreeHeapSize());
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* Print the unused stack of each task since the start [words] */
+					sprintf(str_buffer, "stat stack %u %u %u %u %u %u",
+							(unsigned int) uxTaskGetStackHighWaterMark(taskCommInterpHandle),
+							(unsigned int) uxTaskGetStackHighWaterMark(taskControllerHandle),
+							(unsigned int) uxTaskGetStackHighWaterMark(taskDataAcquisitionHandle),
+							(unsigned int) uxTaskGetStackHighWaterMark(taskDataProcessingHandle),
+							(unsigned int) uxTaskGetStackHighWaterMark(taskGatekeeperHandle),
+							(unsigned int) uxTaskGetStackHighWaterMark(taskScannerHandle));
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+				}
+
+				/* Read the next user command */
+				xQueueSend(queueReadCommand, &g_systemState.readcommand, portMAX_DELAY);
+				break;
+
+			/* Sends the captured scans */
+			case UC_GetCapture:
+				if (g_systemState.state == MODE_CMD) {
+					capture_frames = taskDataProcessingCaptureFrames(&capture_bytes);
+					sprintf(str_buffer, "capture %u %u", (unsigned int) capture_frames, (unsigned int) capture_bytes);
+					sendMessage(MSG_TYPE_CONF, str_buffer);
+
+					/* One frame after the other, at the speed of the serial interface */
+					for (i=0; i<capture_frames; i++) {
+						capture_busy = 1;
+						capture_block.type = MSG_TYPE_CAPTURE;
+						capture_block.msg = taskDataProcessingCaptureFrame(i, &capture_block.length);
+						capture_block.busy = &capture_busy;
+						xQueueSend(queueMessageBlock, &capture_block, portMAX_DELAY);
+						while (capture_busy) {
+							vTaskDelay(10/portTICK_PERIOD_MS);
+						}
+					}
 				}
 
 				/* Read the next user command */
@@ -589,7 +1465,7 @@ void taskController(void* pvParameters) {
 				}
 				break;
 
-			/* No space available in memory pool */
+			/* Sustained faults, mostly no space available in memory pool */
 			case Fault_MemoryPool:
 				/* Set the error LED */
 				bsp_LedSetOn(LED_MALFUNCTION);
@@ -599,7 +1475,7 @@ void taskController(void* pvParameters) {
 				stopDataAcquisition();
 				break;
 
-			/* Not allowed pointer to raw data memory */
+			/* Sustained faults, mostly not allowed pointer to raw data memory */
 			case Fault_MemoryPoolPtr:
 				/* Set the error LED */
 				bsp_LedSetOn(LED_MALFUNCTION);
@@ -609,7 +1485,7 @@ void taskController(void* pvParameters) {
 				stopDataAcquisition();
 				break;
 
-			/* Not ready for the next data point */
+			/* Sustained faults, mostly not ready for the next data point */
 			case Fault_Timing:
 				/* Set the error LED */
 				bsp_LedSetOn(LED_MALFUNCTION);
@@ -635,7 +1511,7 @@ void taskController(void* pvParameters) {
 /**
  * \brief	Send a message to the user over the gatekeeper task.
  * \param[in]	msg_type is the message type.
- * \param[in]	msg is the string.
+ * \param[in]	msg is the string. It is cut to MESSAGE_STRING_LENGTH-1 characters.
  */
 void sendMessage(char msg_type, const char* msg) {
 	message_t message;
@@ -643,7 +1519,8 @@ void sendMessage(char msg_type, const char* msg) {
 	/* Build the message structure */
 	message.type = msg_type;
 	if (msg_type != MSG_TYPE_RSP || g_systemState.comm_respmsg) {
-		strcpy(message.msg, msg);
+		strncpy(message.msg, msg, MESSAGE_STRING_LENGTH - 1);
+		message.msg[MESSAGE_STRING_LENGTH - 1] = '\0';
 	}
 	else {
 		/* Only the error number */
@@ -656,6 +1533,154 @@ void sendMessage(char msg_type, const char* msg) {
 	xQueueSend(queueMessage, &message, portMAX_DELAY);
 }
 
+/**
+ * \brief	Sets a new scan configuration of the selected profile, if its timing
+ * 			is feasible. The scan rate is the engine speed, so it is changed
+ * 			in all profiles. The result is sent to the user. On success, it is
+ * 			the acknowledge followed by the laser pulses of the main sector and
+ * 			the points per second of the plan. In the data mode, the running
+ * 			data acquisition takes it over at the start of a turn.
+ * \param[in]	config is the new scan configuration.
+ */
+void setScanConfig(const scanconfig_t *config) {
+	scanconfig_t other_config;
+	scanplan_t plan, other_plan;
+	uint8_t result;
+	uint8_t i;
+	char str_buffer[MESSAGE_STRING_LENGTH];
+
+	/* Check if the configuration is feasible */
+	result = taskDataAcquisitionPlan(config, &plan);
+
+	/* Check the other profiles with this scan rate */
+	for (i=0; i<DA_PROFILE_MAX && result == DA_PLAN_OK; i++) {
+		if (i != g_systemState.scan_profile && g_systemState.scan[i].rate != config->rate) {
+			other_config = g_systemState.scan[i];
+			other_config.rate = config->rate;
+			result = taskDataAcquisitionPlan(&other_config, &other_plan);
+		}
+	}
+
+	switch (result) {
+		case DA_PLAN_OK:
+			/* Change the system state */
+			for (i=0; i<DA_PROFILE_MAX; i++) {
+				if (g_systemState.scan[i].rate != config->rate) {
+					g_systemState.scan[i].rate = config->rate;
+					taskDataAcquisitionPlan(&g_systemState.scan[i], &g_systemState.scan_plan[i]);
+				}
+			}
+			g_systemState.scan[g_systemState.scan_profile] = *config;
+			g_systemState.scan_plan[g_systemState.scan_profile] = plan;
+
+			/* Send the acknowledge and the plan to the user */
+			sendMessage(MSG_TYPE_RSP, "00 aok");
+			sprintf(str_buffer, "scan plan %u %u", (unsigned int) plan.sector[0].pulses,
+					(unsigned int) plan.points_per_second);
+			sendMessage(MSG_TYPE_CONF, str_buffer);
+			updateScanProfiles();
+			break;
+
+		case DA_PLAN_OVERLAP:
+			/* Keep the old configuration */
+			sendMessage(MSG_TYPE_RSP, "33 scan sectors overlap");
+			break;
+
+		case DA_PLAN_BINNING:
+			/* Keep the old configuration */
+			sendMessage(MSG_TYPE_RSP, "34 scan binning too large");
+			break;
+
+		default:
+			/* Keep the old configuration */
+			sendMessage(MSG_TYPE_RSP, "32 scan timing infeasible");
+			break;
+	}
+}
+
+/**
+ * \brief	Sets a new range gate. The far limit shortens the laser pulse period,
+ * 			so all profiles are planned again. If one of them gets infeasible,
+ * 			the old gate is kept. The result is sent to the user. On success,
+ * 			it is the acknowledge followed by the new laser pulse period.
+ * \param[in]	gate_min is the near limit of the hits, 0 if disabled. [mm]
+ * \param[in]	gate_max is the far limit of the hits, 0 if disabled. [mm]
+ */
+void setScanGate(uint16_t gate_min, uint16_t gate_max) {
+	dataprocessing_t data_processing_config;
+	scanplan_t plan[DA_PROFILE_MAX];
+	uint16_t period;
+	uint8_t result = DA_PLAN_OK;
+	uint8_t i;
+	char str_buffer[MESSAGE_STRING_LENGTH];
+
+	/* Plan all profiles with the new laser pulse period */
+	period = taskDataAcquisitionGatePeriod(gate_max);
+	for (i=0; i<DA_PROFILE_MAX && result == DA_PLAN_OK; i++) {
+		result = taskDataAcquisitionPlanPeriod(&g_systemState.scan[i], period, &plan[i]);
+	}
+
+	if (result != DA_PLAN_OK) {
+		/* Keep the old configuration */
+		sendMessage(MSG_TYPE_RSP, "32 scan timing infeasible");
+		return;
+	}
+
+	/* Change the system state */
+	taskDataAcquisitionSetPeriod(period);
+	g_systemState.scan_gate_min = gate_min;
+	g_systemState.scan_gate_max = gate_max;
+	memcpy(g_systemState.scan_plan, plan, sizeof(plan));
+
+	/* Hand over the gate to the data processing */
+	data_processing_config.config = DATA_PROCESSING_GATE;
+	data_processing_config.param.gate.min = gate_min;
+	data_processing_config.param.gate.max = gate_max;
+	xQueueSend(queueDataProcessing, &data_processing_config, portMAX_DELAY);
+
+	/* Send the acknowledge and the laser pulse period to the user */
+	sendMessage(MSG_TYPE_RSP, "00 aok");
+	sprintf(str_buffer, "scan laser %u", (unsigned int) DA_LASER_PULSE_NS(period));
+	sendMessage(MSG_TYPE_CONF, str_buffer);
+}
+
+/**
+ * \brief	Gets the scan settings of the data acquisition, planned again with
+ * 			the latest measured interrupt costs.
+ * \param[out]	scan is the scan settings, with the planned laser pulses.
+ */
+void getScanProfiles(scanprofiles_t *scan) {
+	uint8_t i, j;
+
+	scan->selected = g_systemState.scan_profile;
+	scan->alternate = g_systemState.scan_alternate;
+	scan->calibration = g_systemState.scan_calib;
+	for (i=0; i<DA_PROFILE_MAX; i++) {
+		scan->profile[i] = g_systemState.scan[i];
+
+		/* Plan again with the latest measured interrupt costs */
+		taskDataAcquisitionPlan(&g_systemState.scan[i], &g_systemState.scan_plan[i]);
+		for (j=0; j<DA_SECTOR_MAX; j++) {
+			scan->profile[i].sector[j].pulses = g_systemState.scan_plan[i].sector[j].pulses;
+		}
+	}
+}
+
+/**
+ * \brief	Hands over the changed scan settings to the running data
+ * 			acquisition. They are taken over at the start of a turn, which is
+ * 			told to the user as "scan update <scan id>".
+ */
+void updateScanProfiles(void) {
+	dataacquisition_t data_acquisition_config;
+
+	if (g_systemState.state == MODE_DATA) {
+		data_acquisition_config.state = DATA_ACQUISITION_UPDATE;
+		getScanProfiles(&data_acquisition_config.param.scan);
+		xQueueSend(queueDataAcquisition, &data_acquisition_config, portMAX_DELAY);
+	}
+}
+
 /**
  * \brief	Set the malfunction LED for 3 seconds.
  * 			This Function is retriggerable.
@@ -677,7 +1702,8 @@ void stopDataAcquisition(void) {
 	/* Stop the data acquisition as soon as possible */
 	data_acquisition_config.state = DATA_ACQUISITION_DISABLE;
 	/* After a malfunction, stop the engine without a delay */
-	data_acquisition_config.param.engine_sleep = 0;
+	data_acquisition_config.param.engine.sleep = 0;
+	data_acquisition_config.param.engine.rate = 0;
 	xQueueSend(queueDataAcquisition, &data_acquisition_config, portMAX_DELAY);
 
 	if (g_systemState.state == MODE_DATA) {
@@ -13,6 +13,8 @@
  */
 
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
 /* RTOS */
 #include "FreeRTOS.h"
@@ -22,8 +24,8 @@
 #include "timers.h"
 
 /* Application */
-#include "task_dataacquisition.h"
 #include "task_controller.h"
+#include "task_dataacquisition.h"
 #include "task_scanner.h"
 #include "task_dataprocessing.h"
 
@@ -44,14 +46,52 @@
  * ----------------------------------------------------------------------------
  */
 
+/**
+ * \brief	Measurement point of the acquisition schedule.
+ */
+typedef struct {
+	uint16_t increments;		/*!< Azimuth of the measurement point. [increments] */
+	uint8_t pulses;				/*!< Number of laser pulses. */
+	uint8_t flags;				/*!< Position of the point in its bin. */
+} schedulepoint_t;
+
+#define POINT_BIN_FIRST		0x01	/*!< First point of a bin, it takes a raw data block. */
+#define POINT_BIN_LAST		0x02	/*!< Last point of a bin, it sends the raw data block. */
+
+/**
+ * \brief	Memory barrier in front of the pending flag of a schedule, so the
+ * 			interrupt never takes over a half written schedule. The __DMB() of
+ * 			this CMSIS version does not keep the compiler from moving the
+ * 			stores, so the barrier also clobbers the memory.
+ */
+#define SCHEDULE_BARRIER()	__asm volatile ("dmb" : : : "memory")
+
+/**
+ * \brief	Acquisition schedule of one turn. The first point is the distance
+ * 			calibration on the reference mark, followed by the points of all
+ * 			sectors in the order of the turn.
+ */
+typedef struct {
+	uint32_t length;			/*!< Number of measurement points. */
+	uint8_t profile;			/*!< Scan profile of the schedule. */
+	uint8_t calibration;		/*!< Number of turns between two calibrations. */
+	uint8_t update;				/*!< TRUE if it is the first schedule of changed scan settings. */
+	schedulepoint_t point[DA_SCHEDULE_LENGTH];	/*!< Measurement points. */
+} schedule_t;
+
 /**
  * \brief	Structure of all necessary configuration of the data acquisition.
  */
 typedef struct {
-	uint32_t azimuth_left;		/*!< Left azimuth of the scanning area. */
-	uint32_t azimuth_right;		/*!< Right azimuth of the scanning area. */
-	uint32_t azimuth_res;		/*!< Resolution between two measurement points. */
-	uint32_t laser_pulses;		/*!< Number of laser pulses each measurement point. */
+	uint32_t index;				/*!< Schedule index of the current measurement point. */
+	uint32_t raw_start;			/*!< Hits in the bin before the running sequence. */
+	uint8_t scan_id;			/*!< Number of the current turn. */
+	uint8_t dynamic;			/*!< TRUE if the schedule is compiled again each turn. */
+	uint8_t busy;				/*!< TRUE while a laser pulse sequence is running. */
+	uint8_t send;				/*!< TRUE if the raw data is sent after the running sequence. */
+	uint8_t tdc_checked;		/*!< TRUE if the TDC state was checked after missing hits in this turn. */
+	uint8_t calibrate;			/*!< TRUE if the TDC and the reference mark are calibrated in this turn. */
+	uint8_t cal_countdown;		/*!< Turns until the next calibration. */
 	uint8_t enable;				/*!< State of the data acquisition. TRUE if enabled. */
 } acquisitionconfigs_t;
 
@@ -64,13 +104,22 @@ typedef struct {
 void taskDataAcquisition(void* pvParameters);
 void azimuthTDCCalibrationHandler(uint32_t azimuth);
 void tdcHighSpeedCalibrationHandler(void);
+void tdcTemperatureHandler(void);
 void azimuthMeasurementHandler(uint32_t azimuth);
 void tdcMeasurementHandler(void);
 void laserEndSequenceHandler(void);
+void acquisitionFault(uint8_t fault, uint32_t increments, uint8_t scan_id, BaseType_t *xTaskWoken);
 
 void engineStandByCallback(TimerHandle_t xTimer);
 void DataAcquisitionStartCallback(TimerHandle_t xTimer);
 
+uint8_t sortSectors(const scanconfig_t *config, uint8_t *order);
+uint8_t planSector(const scansector_t *sector, uint8_t rate, uint16_t period, sectorplan_t *plan);
+void compileSchedule(const scanconfig_t *config, schedule_t *schedule);
+uint32_t adaptiveStep(uint32_t increments, uint16_t arc, uint32_t min_step, uint32_t max_step);
+void setScanProfiles(const scanprofiles_t *scan);
+void binSchedule(schedule_t *schedule, uint32_t first, uint8_t binning);
+
 
 /*
  * ----------------------------------------------------------------------------
@@ -100,6 +149,33 @@ QueueHandle_t queueDataAcquisition;
  */
 static acquisitionconfigs_t g_configs;
 
+/**
+ * \brief	Double buffered acquisition schedule, compiled from the scan sectors.
+ */
+static schedule_t g_schedules[2];
+
+/**
+ * \brief	Schedule of the current turn. It is only changed at the turn boundary.
+ */
+static schedule_t * volatile g_schedule;
+
+/**
+ * \brief	TRUE if the other schedule buffer is ready for the next turn.
+ */
+static volatile uint8_t g_schedulePending;
+
+/**
+ * \brief	Current scan profiles, to compile the schedule of each turn. Only the
+ * 			task uses them, the interrupts get the settings of a turn from its
+ * 			schedule.
+ */
+static scanprofiles_t g_scan;
+
+/**
+ * \brief	Last measured distance of each bin over the turn. 0 if unknown. [mm]
+ */
+static int16_t g_range[DA_RANGE_BINS];
+
 /**
  * \brief	Pointer to the storage of the raw data. Get the space form a
  * 			memory pool.
@@ -111,6 +187,12 @@ rawdata_t *g_rawDataPtr;
  */
 uint32_t g_rawCalibrationData;
 
+/**
+ * \brief	Last temperature measurement of the TDC. It is the ratio of the sensor
+ * 			to the reference discharge time, 0 if not measured yet. [1/65536]
+ */
+static uint32_t g_rawTemperature;
+
 /**
  * \brief	Software timer handler for the engine sleep feature.
  */
@@ -121,6 +203,68 @@ TimerHandle_t timerEngineSleep;
  */
 TimerHandle_t timerDataAcquisitionStart;
 
+/**
+ * \brief	Maximum measured time of the azimuth interrupt handler. [CPU cycles]
+ */
+static volatile uint32_t g_isrCyclesAzimuth;
+
+/**
+ * \brief	Maximum measured time of the laser sequence end interrupt handler. [CPU cycles]
+ */
+static volatile uint32_t g_isrCyclesSequence;
+
+/**
+ * \brief	Maximum measured time of the TDC hit interrupt handler. [CPU cycles]
+ */
+static volatile uint32_t g_isrCyclesHit;
+
+/**
+ * \brief	Bus load of the measurement points. The counters are halved before
+ * 			they overflow, so they weight the recent points. They are only
+ * 			written by the laser sequence end handler, which also accounts
+ * 			the hit and the azimuth interrupts of its point.
+ */
+static volatile struct {
+	uint32_t points;			/*!< Number of measured points. */
+	uint32_t spi_bytes;			/*!< SPI bytes transferred with the TDC. */
+	uint32_t isr;				/*!< Interrupts of the measurement. */
+} g_busLoad;
+
+/**
+ * \brief	Degradation of the measurement under load, set by the governor of
+ * 			the data processing.
+ */
+static volatile struct {
+	uint8_t level;				/*!< Governor level, see DP_QOS_DECIMATE. */
+	uint8_t phase;				/*!< Toggles each bin, the odd bins are skipped. */
+	uint32_t skipped;			/*!< Number of skipped bins. */
+	uint32_t reduced;			/*!< Number of points with halved laser pulses. */
+} g_qos;
+
+/**
+ * \brief	Faults of the measurement points. A fault only loses its point, the
+ * 			data acquisition is stopped by sustained faults. The interrupts of
+ * 			the measurement have different priorities, so the counters are
+ * 			changed with masked interrupts.
+ */
+static volatile struct {
+	uint32_t count[DA_FAULTS];	/*!< Number of faults of each kind, see DA_FAULT_POOL. */
+	uint32_t turn;				/*!< Faults of the current turn. */
+	uint8_t turns;				/*!< Consecutive turns with sustained faults. */
+	uint8_t last;				/*!< Kind of the last fault. */
+} g_faults;
+
+/**
+ * \brief	PWM period register of the laser pulses, given by the range gate.
+ */
+static uint16_t g_laserPeriod;
+
+/**
+ * \brief	Last speed set point sent to the scanner. It is 0 if the engine is
+ * 			suspended.
+ */
+static speed_t g_engineSpeed;
+
 
 /*
  * ----------------------------------------------------------------------------
@@ -136,8 +280,8 @@ TimerHandle_t timerDataAcquisitionStart;
  */
 void engineStandByCallback(TimerHandle_t xTimer) {
 	/* Stop the engine */
-	speed_t engine_speed = 0;
-	xQueueSend(queueSpeed, &engine_speed, portMAX_DELAY);
+	g_engineSpeed = 0;
+	xQueueSend(queueSpeed, &g_engineSpeed, portMAX_DELAY);
 }
 
 /**
@@ -147,6 +291,22 @@ void engineStandByCallback(TimerHandle_t xTimer) {
  * 				Not used.
  */
 void DataAcquisitionStartCallback(TimerHandle_t xTimer) {
+	/* Release the raw data of an incomplete bin from the last data acquisition */
+	if (g_rawDataPtr != NULL && !g_configs.busy) {
+		eMemGiveBlock(&memRawData, g_rawDataPtr);
+		g_rawDataPtr = NULL;
+	}
+
+	/* Pulse period of the range gate */
+	bsp_LaserPeriod(g_laserPeriod);
+
+	/* The first turn calibrates the TDC and the reference mark */
+	g_configs.cal_countdown = 0;
+
+	/* The fault rate starts again */
+	g_faults.turn = 0;
+	g_faults.turns = 0;
+
 	/* Starts the data acquisition */
 	g_configs.enable = 1;
 
@@ -200,12 +360,37 @@ void taskDataAcquisitionInit(void) {
 	/* Initialize the quadrature encoder */
 	bsp_QuadencInit();
 
+	/* Enable the cycle counter to measure the interrupt costs */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CYCCNT = 0;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	g_isrCyclesAzimuth = 0;
+	g_isrCyclesSequence = 0;
+	g_isrCyclesHit = 0;
+	memset((void*) &g_busLoad, 0, sizeof(g_busLoad));
+	g_laserPeriod = BSP_LASER_PERIOD;
+
+	/* No degradation and no faults */
+	memset((void*) &g_qos, 0, sizeof(g_qos));
+	memset((void*) &g_faults, 0, sizeof(g_faults));
+
 	/* Disable the data acquisition */
 	g_configs.enable = 0;
+	g_configs.dynamic = 0;
+	g_configs.scan_id = 0;
+	g_configs.busy = 0;
+	g_configs.send = 0;
+	g_configs.tdc_checked = 0;
+	g_configs.calibrate = 0;
+	g_configs.cal_countdown = 0;
 
 	/* Reset the static variables */
+	g_schedule = &g_schedules[0];
+	g_schedulePending = 0;
 	g_rawDataPtr = NULL;
 	g_rawCalibrationData = 0;
+	g_rawTemperature = 0;
+	g_engineSpeed = 0;
 
 	/* Generate the task */
 	xTaskCreate(taskDataAcquisition, TASK_DATAACQUISITION_NAME, TASK_DATAACQUISITION_STACKSIZE,
@@ -231,9 +416,14 @@ void taskDataAcquisitionInit(void) {
 void taskDataAcquisition(void* pvParameters) {
 	dataacquisition_t settings;
 	speed_t engine_speed;
+	speed_t speed_delta;
+	uint32_t setting_time;
+	schedule_t *next_schedule;
 
 	event_t event;
 
+	uint8_t update = 0;
+
 	uint8_t laser_flag;
 	uint8_t laser_flag_last = 1;
 	uint8_t engine_flag;
@@ -241,53 +431,112 @@ void taskDataAcquisition(void* pvParameters) {
 
 	/* Loop forever */
 	for (;;) {
-		/* Wait for new configuration settings. */
-		if (xQueueReceive(queueDataAcquisition, &settings, 100) == pdTRUE) {
+		/* Wait for new configuration settings. The schedule of each turn needs a faster cycle */
+		if (xQueueReceive(queueDataAcquisition, &settings,
+				(g_configs.enable && (g_configs.dynamic || update)) ? DA_ADAPTIVE_PERIOD/portTICK_PERIOD_MS : 100) == pdTRUE) {
 			/* Check the new state */
 			if (settings.state == DATA_ACQUISITION_ENABLE) {
 				/* Starts the data acquisition */
-				engine_speed = settings.param.scan.rate * (BSP_QUADENC_INC_PER_TURN+1) / (1000*ENGINE_CONTROLER_TA);
-
-				/* Starts the engine */
+				engine_speed = settings.param.scan.profile[0].rate * (BSP_QUADENC_INC_PER_TURN+1) / (1000*ENGINE_CONTROLER_TA);
+				setScanProfiles(&settings.param.scan);
+				update = 0;
+
+				/* Calculate the measurement points of the first turn, without range information.
+				 * It is taken over at the first turn boundary. */
+				memset(g_range, 0, sizeof(g_range));
+				g_schedules[0].profile = g_scan.alternate ? 0 : g_scan.selected;
+				compileSchedule(&g_scan.profile[g_schedules[0].profile], &g_schedules[0]);
+				g_schedules[0].calibration = g_scan.calibration;
+				g_schedules[0].update = 0;
+				g_schedule = &g_schedules[1];
+				SCHEDULE_BARRIER();
+				g_schedulePending = 1;
+
+				/* The engine does not have to be suspended anymore */
 				xTimerStop(timerEngineSleep, portMAX_DELAY);
-				xQueueSend(queueSpeed, &engine_speed, portMAX_DELAY);
-
-				/* Calculate the settings */
-				g_configs.azimuth_left = tenthdegree2increments(settings.param.scan.bndry_left);
-				g_configs.azimuth_right = tenthdegree2increments(settings.param.scan.bndry_right);
-				g_configs.azimuth_res = tenthdegree2increments_Relative(settings.param.scan.step);
-				g_configs.laser_pulses =  DA_LASERPULSE / settings.param.scan.rate;
-
-				/* Check if the engine is running */
-				if (xTimerIsTimerActive(timerEngineSleep) != pdFALSE) {
-					/* Stops the engine delay sleep timer */
-					xTimerStop(timerEngineSleep, portMAX_DELAY);
-					/* Starts the data acquisition direct */
-					DataAcquisitionStartCallback(NULL);
+
+				/* Check if the engine is still running (standby or sleep delay) */
+				if (g_engineSpeed != 0) {
+					/* Only the speed difference has to be settled */
+					speed_delta = abs(engine_speed - g_engineSpeed);
+					g_engineSpeed = engine_speed;
+
+					if (speed_delta == 0) {
+						/* Starts the data acquisition direct */
+						DataAcquisitionStartCallback(NULL);
+					}
+					else {
+						/* Starts the engine with the new speed */
+						xQueueSend(queueSpeed, &engine_speed, portMAX_DELAY);
+
+						/* Setting time proportional to the speed change */
+						setting_time = ENGINE_SETTING_TIME * speed_delta / engine_speed;
+						if (setting_time < ENGINE_DELTA_SETTING_TIME) {
+							setting_time = ENGINE_DELTA_SETTING_TIME;
+						}
+						else if (setting_time > ENGINE_SETTING_TIME) {
+							setting_time = ENGINE_SETTING_TIME;
+						}
+
+						/* Starts after the reduced time delay */
+						xTimerChangePeriod(timerDataAcquisitionStart, setting_time/portTICK_PERIOD_MS, portMAX_DELAY);
+					}
 				}
 				else {
-					/* Starts after a small time delay */
-					xTimerStart(timerDataAcquisitionStart, portMAX_DELAY);
+					/* Starts the engine */
+					g_engineSpeed = engine_speed;
+					xQueueSend(queueSpeed, &engine_speed, portMAX_DELAY);
+
+					/* Starts after the full setting time */
+					xTimerChangePeriod(timerDataAcquisitionStart, ENGINE_SETTING_TIME/portTICK_PERIOD_MS, portMAX_DELAY);
 				}
 			}
+			else if (settings.state == DATA_ACQUISITION_UPDATE) {
+				/* New scan settings of the running data acquisition. They are
+				 * compiled as soon as the other schedule buffer is free */
+				setScanProfiles(&settings.param.scan);
+				update = 1;
+			}
 			else {
 				/* Stops the data acquisition */
 				xTimerStop(timerDataAcquisitionStart, portMAX_DELAY);
 				g_configs.enable = 0;
 
+				/* Check the standby policy of the engine */
+				if (settings.param.engine.rate > 0) {
+					/* Keep the mirror turning with the standby speed */
+					engine_speed = settings.param.engine.rate * (BSP_QUADENC_INC_PER_TURN+1) / (1000*ENGINE_CONTROLER_TA);
+					if (engine_speed != g_engineSpeed) {
+						g_engineSpeed = engine_speed;
+						xQueueSend(queueSpeed, &engine_speed, portMAX_DELAY);
+					}
+				}
 				/* Stop the engine after a given time delay */
-				if (settings.param.engine_sleep > 0) {
-					xTimerChangePeriod(timerEngineSleep, settings.param.engine_sleep, portMAX_DELAY);
+				else if (settings.param.engine.sleep > 0) {
+					xTimerChangePeriod(timerEngineSleep, settings.param.engine.sleep, portMAX_DELAY);
 					xTimerStart(timerEngineSleep, portMAX_DELAY);
 				}
 				else {
 					/* Stop the engine now */
-					engine_speed = 0;
-					xQueueSend(queueSpeed, &engine_speed, portMAX_DELAY);
+					g_engineSpeed = 0;
+					xQueueSend(queueSpeed, &g_engineSpeed, portMAX_DELAY);
 				}
 			}
 		}
 
+		/* Prepare the schedule of the next turn with the next profile and the last distances,
+		 * or with the changed scan settings */
+		if (g_configs.enable && (g_configs.dynamic || update) && !g_schedulePending) {
+			next_schedule = (g_schedule == &g_schedules[0]) ? &g_schedules[1] : &g_schedules[0];
+			next_schedule->profile = g_scan.alternate ? (g_schedule->profile + 1) % DA_PROFILE_MAX : g_scan.selected;
+			compileSchedule(&g_scan.profile[next_schedule->profile], next_schedule);
+			next_schedule->calibration = g_scan.calibration;
+			next_schedule->update = update;
+			update = 0;
+			SCHEDULE_BARRIER();
+			g_schedulePending = 1;
+		}
+
 		/* Make the system check of the data acquisition module */
 
 		/* --- Laser driver error flag ------------------------ */
@@ -325,6 +574,433 @@ void taskDataAcquisition(void* pvParameters) {
 }
 
 
+/**
+ * \brief	Takes over the scan profiles. The schedule changes each turn with
+ * 			alternating or range adaptive profiles.
+ * \param[in]	scan is the scan settings, with the planned laser pulses.
+ */
+void setScanProfiles(const scanprofiles_t *scan) {
+	uint8_t i;
+
+	g_scan = *scan;
+	g_configs.dynamic = g_scan.alternate;
+	for (i=0; i<DA_PROFILE_MAX; i++) {
+		if ((g_scan.alternate || i == g_scan.selected) && g_scan.profile[i].arc) {
+			g_configs.dynamic = 1;
+		}
+	}
+}
+
+/**
+ * \brief	Plans the timing of a scan configuration with the current laser
+ * 			pulse period.
+ * \param[in]	config is the scan configuration.
+ * \param[out]	plan is the resulting timing plan.
+ * \return	The result of taskDataAcquisitionPlanPeriod().
+ */
+uint8_t taskDataAcquisitionPlan(const scanconfig_t *config, scanplan_t *plan) {
+	return taskDataAcquisitionPlanPeriod(config, g_laserPeriod, plan);
+}
+
+/**
+ * \brief	Plans the timing of a scan configuration. Each sector is planned on
+ * 			its own, and the last point of a sector must be measured before
+ * 			the first point of the next sector.
+ * \param[in]	config is the scan configuration.
+ * \param[in]	period is the PWM period register of the laser pulses.
+ * \param[out]	plan is the resulting timing plan.
+ * \return	DA_PLAN_OK if the configuration is feasible, DA_PLAN_OVERLAP if two
+ * 			sectors overlap, DA_PLAN_BINNING if a bin exceeds the raw data block
+ * 			or DA_PLAN_TIMING if the laser pulses do not fit.
+ */
+uint8_t taskDataAcquisitionPlanPeriod(const scanconfig_t *config, uint16_t period, scanplan_t *plan) {
+	uint8_t order[DA_SECTOR_MAX];
+	uint8_t count, i;
+	uint8_t result = DA_PLAN_OK;
+	const scansector_t *sector, *previous;
+	int16_t last_azimuth;
+	uint32_t gap_time;
+
+	/* Plan each enabled sector */
+	plan->points = 0;
+	for (i=0; i<DA_SECTOR_MAX; i++) {
+		if (config->sector[i].step > 0) {
+			if (!planSector(&config->sector[i], config->rate, period, &plan->sector[i])) {
+				result = DA_PLAN_TIMING;
+			}
+
+			/* The pooled laser pulses must fit into one raw data block */
+			if (plan->sector[i].pulses * config->binning > DA_LASERPULSE_MAX) {
+				if (config->sector[i].pulses) {
+					return DA_PLAN_BINNING;
+				}
+				plan->sector[i].pulses = DA_LASERPULSE_MAX / config->binning;
+			}
+			plan->points += (plan->sector[i].points + config->binning - 1) / config->binning;
+		}
+		else {
+			memset(&plan->sector[i], 0, sizeof(sectorplan_t));
+		}
+	}
+	plan->points_per_second = plan->points * config->rate;
+
+	/* Check the transitions between the sectors */
+	count = sortSectors(config, order);
+	for (i=1; i<count; i++) {
+		previous = &config->sector[order[i-1]];
+		sector = &config->sector[order[i]];
+
+		/* Last measurement point of the previous sector */
+		last_azimuth = previous->left + (previous->right - previous->left) / previous->step * previous->step;
+		if (sector->left <= last_azimuth) {
+			return DA_PLAN_OVERLAP;
+		}
+
+		/* Time until the first point of the next sector */
+		gap_time = (uint64_t) (tenthdegree2increments(sector->left) - tenthdegree2increments(last_azimuth))
+				* 1000000000ULL / ((BSP_QUADENC_INC_PER_TURN+1) * config->rate);
+		if (gap_time / 100 * (100 - DA_TIMING_MARGIN) < plan->sector[order[i-1]].point_cost) {
+			result = DA_PLAN_TIMING;
+		}
+	}
+
+	return result;
+}
+
+/**
+ * \brief	Plans the timing of a scan sector. The time between two
+ * 			measurement points is given by the scan rate and step. It must
+ * 			cover the laser pulses and the measured interrupt costs, minus a
+ * 			margin for the speed variation of the engine.
+ * \param[in]	sector is the scan sector.
+ * \param[in]	rate is the scan rate. [turns per second]
+ * \param[in]	period is the PWM period register of the laser pulses.
+ * \param[out]	plan is the resulting timing plan of the sector.
+ * \return	FALSE if the requested laser pulses do not fit into the time
+ * 			between two measurement points.
+ */
+uint8_t planSector(const scansector_t *sector, uint8_t rate, uint16_t period, sectorplan_t *plan) {
+	uint32_t increments;
+	uint32_t budget;
+	uint32_t isr_cost;
+	uint32_t azimuth_ns, sequence_ns, hit_ns;
+	uint32_t pulse_ns = DA_LASER_PULSE_NS(period);
+
+	/* Time between two measurement points, based on the effective increments */
+	increments = tenthdegree2increments_Relative(sector->step);
+	if (increments == 0) {
+		increments = 1;
+	}
+	plan->step_time = (uint64_t) increments * 1000000000ULL / ((BSP_QUADENC_INC_PER_TURN+1) * rate);
+	plan->points = (sector->right - sector->left) / sector->step + 1;
+
+	/* Interrupt costs each point, use the assumption until it was measured */
+	taskDataAcquisitionIsrCost(&azimuth_ns, &sequence_ns, &hit_ns);
+	isr_cost = azimuth_ns + sequence_ns;
+	if (isr_cost == 0) {
+		isr_cost = DA_ISR_COST_NS;
+	}
+
+	/* Usable time for the laser pulses */
+	budget = plan->step_time / 100 * (100 - DA_TIMING_MARGIN);
+	if (budget > isr_cost) {
+		plan->max_pulses = (budget - isr_cost) / pulse_ns;
+	}
+	else {
+		plan->max_pulses = 0;
+	}
+	if (plan->max_pulses > DA_LASERPULSE_MAX) {
+		plan->max_pulses = DA_LASERPULSE_MAX;
+	}
+
+	/* Select or validate the number of laser pulses */
+	plan->pulses = sector->pulses ? sector->pulses : plan->max_pulses;
+	if (plan->pulses == 0) {
+		/* Nothing fits, but a point needs at least one pulse */
+		plan->pulses = 1;
+	}
+	plan->point_cost = plan->pulses * pulse_ns + isr_cost;
+
+	return plan->pulses <= plan->max_pulses;
+}
+
+/**
+ * \brief	Sorts the enabled sectors by their left boundary.
+ * \param[in]	config is the scan configuration.
+ * \param[out]	order is the list of the sorted sector numbers.
+ * \return	Number of enabled sectors.
+ */
+uint8_t sortSectors(const scanconfig_t *config, uint8_t *order) {
+	uint8_t count = 0;
+	uint8_t i, j;
+
+	/* Insertion sort, there are only a few sectors */
+	for (i=0; i<DA_SECTOR_MAX; i++) {
+		if (config->sector[i].step > 0) {
+			for (j=count; j>0 && config->sector[order[j-1]].left > config->sector[i].left; j--) {
+				order[j] = order[j-1];
+			}
+			order[j] = i;
+			count++;
+		}
+	}
+
+	return count;
+}
+
+/**
+ * \brief	Compiles the scan sectors into the acquisition schedule of a turn.
+ * 			The laser pulses of the sectors must already be planned. With a
+ * 			target arc length, the step of each point is chosen from the
+ * 			distance measured at this azimuth over the last turn. It is bound
+ * 			by the encoder resolution or the timing of the laser pulses and by
+ * 			the step of the sector.
+ * 			Adjacent points of a sector are pooled into bins.
+ * \param[in]	config is the scan configuration.
+ * \param[out]	schedule is the compiled schedule.
+ */
+void compileSchedule(const scanconfig_t *config, schedule_t *schedule) {
+	uint8_t order[DA_SECTOR_MAX];
+	uint8_t count, i;
+	const scansector_t *sector;
+	sectorplan_t plan;
+	int16_t azimuth;
+	uint32_t increments, end;
+	uint32_t min_step, max_step;
+	uint32_t next_increments = 0;
+	uint32_t first;
+
+	/* The distance calibration on the reference mark is the first point */
+	schedule->point[0].increments = tenthdegree2increments(DA_AZIMUTH_CAL_DIST);
+	schedule->point[0].pulses = config->sector[0].pulses;
+	schedule->point[0].flags = POINT_BIN_FIRST | POINT_BIN_LAST;
+	schedule->length = 1;
+
+	/* Add the points of all sectors in the order of the turn */
+	count = sortSectors(config, order);
+	for (i=0; i<count; i++) {
+		sector = &config->sector[order[i]];
+		first = schedule->length;
+
+		if (config->arc == 0) {
+			/* Fixed step size */
+			for (azimuth = sector->left; azimuth <= sector->right && schedule->length < DA_SCHEDULE_LENGTH;
+					azimuth += sector->step) {
+				schedule->point[schedule->length].increments = tenthdegree2increments(azimuth);
+				schedule->point[schedule->length].pulses = sector->pulses;
+				schedule->length++;
+			}
+		}
+		else {
+			/* Smallest step, which leaves enough time for the laser pulses */
+			planSector(sector, config->rate, g_laserPeriod, &plan);
+			min_step = ((uint64_t) plan.point_cost * 100 / (100 - DA_TIMING_MARGIN)
+					* ((BSP_QUADENC_INC_PER_TURN+1) * config->rate) + 999999999ULL) / 1000000000ULL;
+			if (min_step < DA_ADAPTIVE_MIN_INC) {
+				min_step = DA_ADAPTIVE_MIN_INC;
+			}
+			max_step = tenthdegree2increments_Relative(sector->step);
+			if (max_step < min_step) {
+				max_step = min_step;
+			}
+
+			/* Range adaptive step size */
+			increments = tenthdegree2increments(sector->left);
+			if (increments < next_increments) {
+				increments = next_increments;
+			}
+			end = tenthdegree2increments(sector->right);
+			while (increments <= end && schedule->length < DA_SCHEDULE_LENGTH) {
+				schedule->point[schedule->length].increments = increments;
+				schedule->point[schedule->length].pulses = sector->pulses;
+				schedule->length++;
+				increments += adaptiveStep(increments, config->arc, min_step, max_step);
+			}
+
+			/* The first point of the next sector must leave time for the last one */
+			next_increments = schedule->point[schedule->length-1].increments + min_step;
+		}
+
+		/* Pool the points of the sector */
+		binSchedule(schedule, first, config->binning);
+	}
+}
+
+/**
+ * \brief	Groups the last points of the schedule into bins. The last bin
+ * 			can be smaller.
+ * \param[in,out]	schedule is the schedule.
+ * \param[in]	first is the index of the first point to group.
+ * \param[in]	binning is the number of points each bin.
+ */
+void binSchedule(schedule_t *schedule, uint32_t first, uint8_t binning) {
+	uint32_t i;
+
+	for (i=first; i<schedule->length; i++) {
+		schedule->point[i].flags = 0;
+		if ((i - first) % binning == 0) {
+			schedule->point[i].flags |= POINT_BIN_FIRST;
+		}
+		if ((i - first) % binning == binning - 1u || i == schedule->length - 1) {
+			schedule->point[i].flags |= POINT_BIN_LAST;
+		}
+	}
+}
+
+/**
+ * \brief	Calculates the step size to the next measurement point for a
+ * 			target arc length. The arc length of a step is the distance times
+ * 			the angle.
+ * \param[in]	increments is the azimuth of the current point.
+ * \param[in]	arc is the target arc length. [mm]
+ * \param[in]	min_step is the smallest allowed step. [increments]
+ * \param[in]	max_step is the largest allowed step. [increments]
+ * \return	Step size to the next point. [increments]
+ */
+uint32_t adaptiveStep(uint32_t increments, uint16_t arc, uint32_t min_step, uint32_t max_step) {
+	int16_t distance;
+	uint32_t step;
+
+	/* Unknown distances were sampled with the step of the sector */
+	distance = g_range[(increments / DA_RANGE_BIN_INC) % DA_RANGE_BINS];
+	if (distance <= 0) {
+		return max_step;
+	}
+
+	/* Step angle for the arc length: arc / distance [rad] */
+	step = (uint32_t) arc * (BSP_QUADENC_INC_PER_TURN+1) * 1000 / (6283UL * distance);
+
+	/* Bound to the encoder resolution, the timing and the sector */
+	if (step < min_step) {
+		step = min_step;
+	}
+	else if (step > max_step) {
+		step = max_step;
+	}
+
+	return step;
+}
+
+/**
+ * \brief	Feeds back a measured distance to the range adaptive sampling. It
+ * 			is used by the schedule of the next turn.
+ * \param[in]	increments is the azimuth of the measurement point.
+ * \param[in]	distance is the measured distance, 0 if it is unknown. [mm]
+ */
+void taskDataAcquisitionSetRange(uint32_t increments, int16_t distance) {
+	g_range[(increments / DA_RANGE_BIN_INC) % DA_RANGE_BINS] = distance;
+}
+
+/**
+ * \brief	Sets the degradation of the measurement by the governor of the data
+ * 			processing. It is taken over at the next point.
+ * \param[in]	level is the governor level, 0 for the full measurement.
+ */
+void taskDataAcquisitionSetQos(uint8_t level) {
+	g_qos.level = level;
+}
+
+/**
+ * \brief	Gets the degraded points of the governor.
+ * \param[out]	skipped is the number of skipped bins.
+ * \param[out]	reduced is the number of points with halved laser pulses.
+ */
+void taskDataAcquisitionQosStats(uint32_t *skipped, uint32_t *reduced) {
+	*skipped = g_qos.skipped;
+	*reduced = g_qos.reduced;
+}
+
+/**
+ * \brief	Gets the number of faults of each kind.
+ * \param[out]	faults is the storage of DA_FAULTS counters, see DA_FAULT_POOL.
+ */
+void taskDataAcquisitionFaults(uint32_t *faults) {
+	uint8_t i;
+
+	for (i=0; i<DA_FAULTS; i++) {
+		faults[i] = g_faults.count[i];
+	}
+}
+
+/**
+ * \brief	Gets the maximum measured interrupt costs of a measurement point.
+ * \param[out]	azimuth_ns is the time of the azimuth interrupt handler. [ns]
+ * \param[out]	sequence_ns is the time of the laser sequence end handler. [ns]
+ * \param[out]	hit_ns is the time of the TDC hit handler. [ns]
+ */
+void taskDataAcquisitionIsrCost(uint32_t *azimuth_ns, uint32_t *sequence_ns, uint32_t *hit_ns) {
+	*azimuth_ns = (uint64_t) g_isrCyclesAzimuth * 1000000000ULL / SystemCoreClock;
+	*sequence_ns = (uint64_t) g_isrCyclesSequence * 1000000000ULL / SystemCoreClock;
+	*hit_ns = (uint64_t) g_isrCyclesHit * 1000000000ULL / SystemCoreClock;
+}
+
+/**
+ * \brief	Gets the bus load each measurement point, averaged over the recent
+ * 			points.
+ * \param[out]	spi_bytes is the number of SPI bytes with the TDC. [tenth per point]
+ * \param[out]	isr is the number of interrupts. [tenth per point]
+ */
+void taskDataAcquisitionBusLoad(uint32_t *spi_bytes, uint32_t *isr) {
+	uint32_t points = g_busLoad.points;
+
+	if (points > 0) {
+		*spi_bytes = (uint64_t) g_busLoad.spi_bytes * 10 / points;
+		*isr = (uint64_t) g_busLoad.isr * 10 / points;
+	}
+	else {
+		*spi_bytes = 0;
+		*isr = 0;
+	}
+}
+
+/**
+ * \brief	Calculates the laser pulse period for a range gate. The GP22 has a
+ * 			fixed range in measurement mode 1, so the next pulse can follow
+ * 			after this range, the round trip time of the gate and the hit
+ * 			interrupt. The period is only a candidate, it is planned with
+ * 			taskDataAcquisitionPlanPeriod() and set with
+ * 			taskDataAcquisitionSetPeriod().
+ * \param[in]	gate_max is the far limit of the range gate, 0 for the default
+ * 				pulse period. [mm]
+ * \return	The PWM period register of the laser pulses.
+ */
+uint16_t taskDataAcquisitionGatePeriod(uint16_t gate_max) {
+	uint32_t azimuth_ns, sequence_ns, hit_ns;
+	uint32_t period_ns;
+	uint16_t period = BSP_LASER_PERIOD;
+
+	if (gate_max != 0) {
+		/* Hit interrupt costs, use the assumption until it was measured */
+		taskDataAcquisitionIsrCost(&azimuth_ns, &sequence_ns, &hit_ns);
+		if (hit_ns == 0) {
+			hit_ns = DA_HIT_COST_NS;
+		}
+
+		/* TDC range, round trip of the light (0.3 mm/ns) and the hit interrupt */
+		period_ns = DA_GP22_RANGE_NS + (uint32_t) gate_max * 2000 / 299792 + hit_ns;
+		if (period_ns < DA_LASER_PERIOD_MIN_NS) {
+			period_ns = DA_LASER_PERIOD_MIN_NS;
+		}
+
+		/* Never slower than the default */
+		if ((uint64_t) period_ns * BSP_LASER_FREQ / 1000000000ULL < BSP_LASER_PERIOD) {
+			period = (uint64_t) period_ns * BSP_LASER_FREQ / 1000000000ULL;
+		}
+	}
+
+	return period;
+}
+
+/**
+ * \brief	Sets the laser pulse period of a planned range gate. It is taken
+ * 			over at the next start of the data acquisition.
+ * \param[in]	period is the PWM period register of the laser pulses.
+ */
+void taskDataAcquisitionSetPeriod(uint16_t period) {
+	g_laserPeriod = period;
+}
+
+
 /*
  * ----------------------------------------------------------------------------
  * TDC high speed clock calibration
@@ -337,12 +1013,60 @@ void taskDataAcquisition(void* pvParameters) {
  */
 void azimuthTDCCalibrationHandler(uint32_t azimuth) {
 	uint32_t reg;
+	event_t error_event;
+	event_t update_event;
+	BaseType_t xTaskWoken = pdFALSE;
+	UBaseType_t mask;
+	uint32_t faults;
 
 	/* Check if it is enabled */
 	if (g_configs.enable) {
+		/* Faults of the last turn, the other interrupts count them */
+		mask = portSET_INTERRUPT_MASK_FROM_ISR();
+		faults = g_faults.turn;
+		g_faults.turn = 0;
+		portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+
+		/* Only sustained faults are told to the controller, it stops the data acquisition */
+		if (faults * 100 > g_schedule->length * DA_FAULT_RATE) {
+			if (++g_faults.turns >= DA_FAULT_TURNS) {
+				error_event.event = (g_faults.last == DA_FAULT_POOL) ? Fault_MemoryPool
+						: (g_faults.last == DA_FAULT_POINTER) ? Fault_MemoryPoolPtr : Fault_Timing;
+				xQueueSendFromISR(queueEvent, &error_event, &xTaskWoken);
+				g_faults.turns = 0;
+			}
+		}
+		else {
+			g_faults.turns = 0;
+		}
+
+		/* Change to the schedule of the next turn, if it is ready */
+		if (g_schedulePending) {
+			g_schedule = (g_schedule == &g_schedules[0]) ? &g_schedules[1] : &g_schedules[0];
+			g_schedulePending = 0;
+		}
+		g_configs.scan_id++;
+		g_configs.tdc_checked = 0;
+
+		/* Tell the controller the first turn of changed scan settings */
+		if (g_schedule->update) {
+			g_schedule->update = 0;
+			update_event.event = Sys_ScanUpdate;
+			update_event.param.scan_id = g_configs.scan_id;
+			xQueueSendFromISR(queueEvent, &update_event, &xTaskWoken);
+		}
+
+		/* The TDC and the reference mark are calibrated every few turns */
+		g_configs.calibrate = (g_configs.cal_countdown == 0);
+		if (g_configs.calibrate) {
+			g_configs.cal_countdown = g_schedule->calibration;
+		}
+		g_configs.cal_countdown--;
+
 		/* Configure the next step: Propagation delay calibration */
+		g_configs.index = 0;
 		bsp_QuadencPosCallback(azimuthMeasurementHandler);
-		bsp_QuadencSetCapture(tenthdegree2increments(DA_AZIMUTH_CAL_DIST));
+		bsp_QuadencSetCapture(g_schedule->point[0].increments);
 
 #if (BSP_GP22_REG0 & (1<<13))
 		/* Disable the automatic calibration calculation on the TDC */
@@ -362,15 +1086,34 @@ void azimuthTDCCalibrationHandler(uint32_t azimuth) {
 		bsp_GP22RegWrite(GP22_WR_REG_2, reg);
 #endif
 
-		/* Starts a calibration measurement for the high speed clock */
-		bsp_GP22IntCallback(tdcHighSpeedCalibrationHandler);
-		bsp_GP22SendOpcode(GP22_OP_Init);
-		bsp_GP22SendOpcode(GP22_OP_Start_Cal_Resonator);
+		/* The idle window behind the scan area is used until the distance calibration */
+		g_configs.busy = 1;
+
+		if (g_configs.calibrate) {
+			/* Starts a calibration measurement for the high speed clock */
+			bsp_GP22IntCallback(tdcHighSpeedCalibrationHandler);
+			bsp_GP22SendOpcode(GP22_OP_Init);
+			bsp_GP22SendOpcode(GP22_OP_Start_Cal_Resonator);
+		}
+		else {
+#if BSP_GP22_TEMP
+			/* Starts a temperature measurement */
+			bsp_GP22IntCallback(tdcTemperatureHandler);
+			bsp_GP22SendOpcode(GP22_OP_Init);
+			bsp_GP22SendOpcode(GP22_OP_Start_Temp);
+#else
+			/* No temperature sensor, the idle window ends here */
+			tdcTemperatureHandler();
+#endif
+		}
 	}
 	else {
 		/* Data acquisition disable */
 		bsp_QuadencPosCallback(NULL);
 	}
+
+	/* Check if a higher prior task is woken up */
+	portEND_SWITCHING_ISR(xTaskWoken);
 }
 
 /**
@@ -381,6 +1124,33 @@ void tdcHighSpeedCalibrationHandler(void) {
 	/* Read the calibration value */
 	bsp_GP22RegRead(GP22_RD_RES_0, &g_rawCalibrationData, 4);
 
+#if BSP_GP22_TEMP
+	/* Followed by a temperature measurement */
+	bsp_GP22IntCallback(tdcTemperatureHandler);
+	bsp_GP22SendOpcode(GP22_OP_Init);
+	bsp_GP22SendOpcode(GP22_OP_Start_Temp);
+#else
+	/* No temperature sensor, the idle window ends here */
+	tdcTemperatureHandler();
+#endif
+}
+
+/**
+ * \brief	TDC interrupt handler, called after a temperature measurement. It
+ * 			ends the use of the idle window. Without BSP_GP22_TEMP, it is
+ * 			called directly after the calibration.
+ */
+void tdcTemperatureHandler(void) {
+#if BSP_GP22_TEMP
+	uint32_t sensor, reference;
+
+	/* Read the discharge times of the sensor and the reference resistor */
+	if (bsp_GP22RegRead(BSP_GP22_TEMP_SENSOR, &sensor, 4)
+			&& bsp_GP22RegRead(BSP_GP22_TEMP_REF, &reference, 4) && reference > 0) {
+		g_rawTemperature = ((uint64_t) sensor << 16) / reference;
+	}
+#endif
+
 	/* Reset the configuration */
 #if (BSP_GP22_REG0 & (1<<13))
 	bsp_GP22RegWrite(GP22_WR_REG_0, BSP_GP22_REG0);
@@ -396,6 +1166,7 @@ void tdcHighSpeedCalibrationHandler(void) {
 
 	/* Make the TDC ready for the measurements (EN_FAST_INIT) */
 	bsp_GP22SendOpcode(GP22_OP_Init);
+	g_configs.busy = 0;
 }
 
 
@@ -410,22 +1181,21 @@ void tdcHighSpeedCalibrationHandler(void) {
  * \param[in]	azimuth is the current azimuth, which called the interrupt.
  */
 void azimuthMeasurementHandler(uint32_t azimuth) {
-	uint32_t next_azimuth;
-	event_t error_event;
+	const schedulepoint_t *point;
+	uint8_t measure = 0;
+	uint8_t pulses;
 	BaseType_t xTaskWoken = pdFALSE;
+	uint32_t cycles = DWT->CYCCNT;
 
 	/* Check if it is enabled */
 	if (g_configs.enable) {
+		/* Current measurement point of the schedule */
+		point = &g_schedule->point[g_configs.index++];
+
 		/* Configure the next azimuth interrupt */
-		next_azimuth = azimuth + g_configs.azimuth_res;
-		if (azimuth == tenthdegree2increments(DA_AZIMUTH_CAL_DIST)) {
-			/* First measurement point */
-			bsp_QuadencPosCallback(azimuthMeasurementHandler);
-			bsp_QuadencSetCapture(g_configs.azimuth_left);
-		}
-		else if (next_azimuth <= g_configs.azimuth_right) {
+		if (g_configs.index < g_schedule->length) {
 			/* Set the next azimuth value */
-			bsp_QuadencSetCapture(next_azimuth);
+			bsp_QuadencSetCapture(g_schedule->point[g_configs.index].increments);
 		}
 		else {
 			/* Scan completed -> restart with calibration */
@@ -434,31 +1204,83 @@ void azimuthMeasurementHandler(uint32_t azimuth) {
 		}
 
 		/* The last sequence must be done */
-		if (g_rawDataPtr == NULL) {
-			/* Get a memory block for the raw data */
-			if (eMemTakeBlockFromISR(&memRawData, (void**)&g_rawDataPtr, &xTaskWoken) == MEM_NO_ERROR) {
-				/* Set the default values */
-				g_rawDataPtr->cal_resonator = g_rawCalibrationData;
-				g_rawDataPtr->increments = azimuth;
-				g_rawDataPtr->expected_points = g_configs.laser_pulses;
-				g_rawDataPtr->raw_ctr = 0;
+		if (!g_configs.busy) {
+			/* The first point of a bin takes the raw data block */
+			if (point->flags & POINT_BIN_FIRST) {
+				if (g_rawDataPtr != NULL) {
+					/* The raw data of the last bin was not sent, the bin is lost */
+					acquisitionFault(DA_FAULT_TIMING, g_rawDataPtr->increments, g_rawDataPtr->scan_id, &xTaskWoken);
+					eMemGiveBlockFromISR(&memRawData, g_rawDataPtr, &xTaskWoken);
+					g_rawDataPtr = NULL;
+				}
+
+				/* The governor skips every second bin, but never the reference mark */
+				if (g_qos.level >= DP_QOS_SKIP && point != &g_schedule->point[0] && (g_qos.phase ^= 1)) {
+					g_qos.skipped++;
+				}
+				/* Get a memory block for the raw data */
+				else if (eMemTakeBlockFromISR(&memRawData, (void**)&g_rawDataPtr, &xTaskWoken) == MEM_NO_ERROR) {
+					/* Set the default values */
+					g_rawDataPtr->cal_resonator = g_rawCalibrationData;
+					g_rawDataPtr->increments = point->increments;
+					g_rawDataPtr->expected_points = 0;
+					g_rawDataPtr->raw_ctr = 0;
+					g_rawDataPtr->scan_id = g_configs.scan_id;
+					g_rawDataPtr->profile = g_schedule->profile;
+					g_rawDataPtr->pulse_width = 0;
+					g_rawDataPtr->calibrate = g_configs.calibrate;
+					g_rawDataPtr->temperature = g_rawTemperature;
+					measure = 1;
+				}
+				else {
+					/* No free memory block, the point is lost */
+					acquisitionFault(DA_FAULT_POOL, (point == &g_schedule->point[0]) ? DA_FAULT_NO_MARKER
+							: point->increments, g_configs.scan_id, &xTaskWoken);
+				}
+			}
+			else if (g_rawDataPtr != NULL) {
+				/* Next point of the bin */
+				if (point->flags & POINT_BIN_LAST) {
+					/* The azimuth of a bin is its center */
+					g_rawDataPtr->increments = (g_rawDataPtr->increments + point->increments) / 2;
+				}
+				measure = 1;
+			}
+
+			/* Without a calibration, the reference mark only marks the scan start */
+			if (measure && point == &g_schedule->point[0] && !g_configs.calibrate) {
+				if (xQueueSendFromISR(queueRawDataPtr, &g_rawDataPtr, &xTaskWoken) != pdTRUE) {
+					/* The scan marker is lost */
+					acquisitionFault(DA_FAULT_POOL, DA_FAULT_NO_MARKER, g_configs.scan_id, &xTaskWoken);
+					eMemGiveBlockFromISR(&memRawData, g_rawDataPtr, &xTaskWoken);
+				}
+				g_rawDataPtr = NULL;
+				measure = 0;
+			}
+
+			/* Add the laser pulses of the point to the bin, the governor halves them under load */
+			if (measure) {
+				pulses = point->pulses;
+				if (g_qos.level >= DP_QOS_PULSES && pulses > 1) {
+					pulses /= 2;
+					g_qos.reduced++;
+				}
+				g_rawDataPtr->expected_points += pulses;
+				g_configs.raw_start = g_rawDataPtr->raw_ctr;
+				g_configs.send = point->flags & POINT_BIN_LAST;
+				g_configs.busy = 1;
 
 				/* Set the TDC callback function */
 				bsp_GP22IntCallback(tdcMeasurementHandler);
 
 				/* Starts a measurement sequence */
-				bsp_LaserPulse(g_configs.laser_pulses);
-			}
-			else {
-				/* Send an error message to the controller */
-				error_event.event = Fault_MemoryPool;
-				xQueueSendFromISR(queueEvent, &error_event, &xTaskWoken);
+				bsp_LaserPulse(pulses);
 			}
 		}
 		else {
-			/* Send an error message to the controller */
-			error_event.event = Fault_Timing;
-			xQueueSendFromISR(queueEvent, &error_event, &xTaskWoken);
+			/* The last sequence is still running, the point is lost */
+			acquisitionFault(DA_FAULT_TIMING, (point == &g_schedule->point[0]) ? DA_FAULT_NO_MARKER
+					: point->increments, g_configs.scan_id, &xTaskWoken);
 		}
 	}
 	else {
@@ -466,6 +1288,12 @@ void azimuthMeasurementHandler(uint32_t azimuth) {
 		bsp_QuadencPosCallback(NULL);
 	}
 
+	/* Measure the interrupt costs */
+	cycles = DWT->CYCCNT - cycles;
+	if (cycles > g_isrCyclesAzimuth) {
+		g_isrCyclesAzimuth = cycles;
+	}
+
 	/* Check if a higher prior task is woken up */
 	portEND_SWITCHING_ISR(xTaskWoken);
 }
@@ -475,20 +1303,25 @@ void azimuthMeasurementHandler(uint32_t azimuth) {
  */
 void tdcMeasurementHandler(void) {
 	uint32_t result;
-	event_t error_event;
 	BaseType_t xTaskWoken = pdFALSE;
+	uint32_t cycles = DWT->CYCCNT;
 
 	/* Check the pointer */
-	if (g_rawDataPtr != NULL) {
+	if (g_rawDataPtr != NULL && g_rawDataPtr->raw_ctr < MAX_RAWDATA_LENGTH) {
 		/* Read the calibration value */
 		bsp_GP22RegRead(GP22_RD_RES_0, &result, 4);
 		/* Safe the raw data */
 		g_rawDataPtr->raw[g_rawDataPtr->raw_ctr++] = result;
 	}
 	else {
-		/* Send error event */
-		error_event.event = Fault_MemoryPoolPtr;
-		xQueueSendFromISR(queueEvent, &error_event, &xTaskWoken);
+		/* The hit is lost */
+		acquisitionFault(DA_FAULT_POINTER, DA_FAULT_NO_MARKER, g_configs.scan_id, &xTaskWoken);
+	}
+
+	/* Measure the interrupt costs */
+	cycles = DWT->CYCCNT - cycles;
+	if (cycles > g_isrCyclesHit) {
+		g_isrCyclesHit = cycles;
 	}
 
 	/* Check if a higher prior task is woken up */
@@ -501,15 +1334,23 @@ void tdcMeasurementHandler(void) {
  */
 void laserEndSequenceHandler(void) {
 	uint32_t stat;
+#if (BSP_GP22_REG3 & (1<<30))
+	uint32_t pulse_width;
+#endif
 	event_t error_event;
 	BaseType_t xTaskWoken = pdFALSE;
+	uint32_t cycles = DWT->CYCCNT;
+	uint32_t hits, spi_bytes = 0;
 
 	/* Check the pointer */
 	if (g_rawDataPtr != NULL) {
-		/* Check the received numbers */
-		if (g_rawDataPtr->raw_ctr < g_configs.laser_pulses) {
+		/* Check the received numbers. Missing reflections are common, so the
+		 * TDC state is only sampled once each turn */
+		if (g_rawDataPtr->raw_ctr < g_rawDataPtr->expected_points && !g_configs.tdc_checked) {
 			/* Not all pulses were successfully -> control sample */
+			g_configs.tdc_checked = 1;
 			bsp_GP22RegRead(GP22_RD_STAT, &stat, 2);
+			spi_bytes += 3;
 			/* Stat is 0x0000 if the last sample was successful,
 			 * Stat is 0x0208 if a timeout occurs due to missing reflection */
 			if (!(stat == 0x0000 || (stat&0xFFF8) == 0x0208)) {
@@ -520,27 +1361,91 @@ void laserEndSequenceHandler(void) {
 			}
 		}
 
-		/* Send the raw data pointer to the data processing task */
-		if (xQueueSendFromISR(queueRawDataPtr, &g_rawDataPtr, &xTaskWoken) == pdTRUE) {
+#if (BSP_GP22_REG3 & (1<<30))
+		/* The first wave mode measures the pulse width of the last hit. It is
+		 * read once each sequence, to keep the SPI load of a point fixed */
+		if (g_rawDataPtr->raw_ctr > 0) {
+			bsp_GP22RegRead(GP22_RD_PW1ST, &pulse_width, 1);
+			g_rawDataPtr->pulse_width = pulse_width;
+			spi_bytes += 2;
+		}
+#endif
+
+		/* Bus load of the point: a 5 byte result read each hit, the azimuth
+		 * interrupt and this one */
+		hits = g_rawDataPtr->raw_ctr - g_configs.raw_start;
+		if (g_busLoad.spi_bytes > 0x40000000) {
+			g_busLoad.points /= 2;
+			g_busLoad.spi_bytes /= 2;
+			g_busLoad.isr /= 2;
+		}
+		g_busLoad.points++;
+		g_busLoad.spi_bytes += spi_bytes + hits * 5;
+		g_busLoad.isr += hits + 2;
+
+		/* Send the raw data pointer to the data processing task at the end of the bin */
+		g_rawDataPtr->cycles = DWT->CYCCNT;
+		if (!g_configs.send) {
+			/* The next point of the bin follows */
+		}
+		else if (xQueueSendFromISR(queueRawDataPtr, &g_rawDataPtr, &xTaskWoken) == pdTRUE) {
 			/* Reset pointer */
 			g_rawDataPtr = NULL;
 		}
 		else {
-			/* Send an error event with the value of the state register */
-			error_event.event = Fault_MemoryPool;
-			xQueueSendFromISR(queueEvent, &error_event, &xTaskWoken);
+			/* No space in the raw data queue, the bin is lost */
+			acquisitionFault(DA_FAULT_POOL, g_rawDataPtr->increments, g_rawDataPtr->scan_id, &xTaskWoken);
+			eMemGiveBlockFromISR(&memRawData, g_rawDataPtr, &xTaskWoken);
+			g_rawDataPtr = NULL;
 		}
 	}
 	else {
-		/* Send error event */
-		error_event.event = Fault_MemoryPoolPtr;
-		xQueueSendFromISR(queueEvent, &error_event, &xTaskWoken);
+		/* A sequence without a bin */
+		acquisitionFault(DA_FAULT_POINTER, DA_FAULT_NO_MARKER, g_configs.scan_id, &xTaskWoken);
+	}
+
+	/* Ready for the next point */
+	g_configs.busy = 0;
+
+	/* Measure the interrupt costs */
+	cycles = DWT->CYCCNT - cycles;
+	if (cycles > g_isrCyclesSequence) {
+		g_isrCyclesSequence = cycles;
 	}
 
 	/* Check if a higher prior task is woken up */
 	portEND_SWITCHING_ISR(xTaskWoken);
 }
 
+/**
+ * \brief	Handles a fault of a measurement point from an interrupt. The fault
+ * 			is counted, and a lost point is told to the data processing, which
+ * 			sends its marker.
+ * \param[in]	fault is the kind of the fault, see DA_FAULT_POOL.
+ * \param[in]	increments is the azimuth of the lost point, or DA_FAULT_NO_MARKER.
+ * \param[in]	scan_id is the turn of the lost point. A bin of the last turn can
+ * 			still be lost after the turn boundary.
+ * \param[out]	xTaskWoken is set to pdTRUE if a higher prior task is woken up.
+ */
+void acquisitionFault(uint8_t fault, uint32_t increments, uint8_t scan_id, BaseType_t *xTaskWoken) {
+	rawdatafault_t lost;
+	UBaseType_t mask;
+
+	/* The interrupts of the measurement have different priorities */
+	mask = portSET_INTERRUPT_MASK_FROM_ISR();
+	g_faults.count[fault]++;
+	g_faults.turn++;
+	g_faults.last = fault;
+	portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+
+	/* The marker is lost as well if the queue is full */
+	if (increments != DA_FAULT_NO_MARKER) {
+		lost.increments = increments;
+		lost.scan_id = scan_id;
+		xQueueSendFromISR(queueRawDataFault, &lost, xTaskWoken);
+	}
+}
+
 
 /**
  * @}
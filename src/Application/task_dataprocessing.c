@@ -13,25 +13,54 @@
  */
 
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
 
 /* RTOS */
 #include "FreeRTOS.h"
 #include "task.h"
 #include "queue.h"
+#include "semphr.h"
 #include "memPoolService.h"
 
 /* Application */
 #include "task_dataprocessing.h"
 #include "task_gatekeeper.h"
 #include "task_controller.h"
+#include "task_dataacquisition.h"
 
 /* BSP */
 #include "bsp_quadenc.h"
 #include "bsp_gp22.h"
+#include "bsp_led.h"
+#include "bsp_serial.h"
 
 /* Utility */
 #include "data_encode.h"
 #include "incs_azimuth.h"
+#include "cartesian.h"
+
+/* Imported function prototypes */
+extern int sprintf(char* str, const char *fmt, ...);
+
+
+/*
+ * ----------------------------------------------------------------------------
+ * Private data types
+ * ----------------------------------------------------------------------------
+ */
+
+/**
+ * \brief	Processed point of the room map, before it is encoded.
+ */
+typedef struct {
+	uint32_t increments;		/*!< Azimuth in increments. */
+	int16_t azimuth;			/*!< Azimuth. [tenth degree] */
+	int16_t distance;			/*!< Distance. [mm] */
+	uint16_t intensity;			/*!< Intensity of the point. */
+	uint8_t scan_id;			/*!< Number of the turn. */
+} point_t;
 
 
 /*
@@ -41,6 +70,39 @@
  */
 void taskDataProcessing(void* pvParameters);
 uint32_t maxValue(uint32_t *data, uint32_t length);
+int16_t temperatureCorrection(const int8_t *table, int16_t temperature);
+int16_t temporalFilter(uint32_t increments, int16_t distance);
+void spatialFilter(const point_t *point);
+void spatialFlush(void);
+uint8_t spatialEvaluate(const point_t *previous, const point_t *current, const point_t *next, point_t *point);
+void sendPoint(const point_t *point);
+uint32_t outputPoint(const point_t *point, char *room_map_point);
+uint32_t encodePoint(const point_t *point, char *base64);
+void cartesianPoint(const point_t *point, int32_t *x, int32_t *y);
+void linesStart(uint8_t scan_id, uint8_t profile);
+void linesAdd(const point_t *point);
+void linesSegment(void);
+void linesComplete(void);
+void zonesCheck(int16_t azimuth, int16_t distance, uint32_t cycles);
+void zonesScan(void);
+void zoneAlarm(uint8_t index, uint8_t alarm, uint32_t latency_us);
+uint8_t backgroundPoint(const point_t *point);
+uint8_t backgroundForeground(const point_t *point);
+void backgroundScan(void);
+void blobAdd(const point_t *point);
+void blobSend(void);
+void trackerPoint(const point_t *point);
+void trackerCluster(void);
+void trackerScan(uint8_t scan_id, uint8_t profile);
+void trackerSend(void);
+void rawDump(const rawdata_t *raw_data);
+void qosUpdate(void);
+void faultMarkers(uint8_t scan_id, uint32_t increments);
+void capturePoint(const point_t *point);
+void captureScan(uint8_t scan_id, uint8_t profile);
+void frameStart(uint8_t scan_id, uint8_t profile);
+void frameComplete(void);
+void frameDeltaEncode(frame_t *frame);
 
 
 /*
@@ -61,6 +123,22 @@ TaskHandle_t taskDataProcessingHandle;
  */
 QueueHandle_t queueRawDataPtr;
 
+/**
+ * \brief	Queue with the settings of the data processing.
+ */
+QueueHandle_t queueDataProcessing;
+
+/**
+ * \brief	Queue set to wait for the raw data and the settings.
+ */
+QueueSetHandle_t queueDataProcessingSet;
+
+/**
+ * \brief	Queue with the increments of the points lost by a fault of the
+ * 			data acquisition.
+ */
+QueueHandle_t queueRawDataFault;
+
 /**
  * \brief	Memory pool with the raw data.
  */
@@ -72,6 +150,274 @@ MemPoolManager memRawData;
 rawdata_t g_memRawDataStorage[Q_RAWDATA_LENGTH];
 
 
+/*
+ * ----------------------------------------------------------------------------
+ * Private variables
+ * ----------------------------------------------------------------------------
+ */
+
+/**
+ * \brief	Hit statistics of the points. The counters are halved before they
+ * 			overflow, so they weight the recent points.
+ */
+static struct {
+	uint32_t expected;			/*!< Expected TDC hits. */
+	uint32_t received;			/*!< Received TDC hits. */
+	uint32_t points;			/*!< Number of points. */
+	uint32_t valid;				/*!< Points with a valid distance. */
+	uint32_t bins[DP_HITS_CLASSES];	/*!< Points (bins) by their received hits, in quarters of the expected hits. */
+} g_hits;
+
+/**
+ * \brief	Last measured temperature of the TDC, 0 if not measured yet. [tenth degree Celsius]
+ */
+static int16_t g_temperature;
+
+/**
+ * \brief	Temporal filter of the distances over the turns. The state of each
+ * 			bin is preallocated for the finest step of the scan.
+ */
+static struct {
+	uint8_t shift;				/*!< Filter weight of the new distance is 1/2^shift, 0 if disabled. */
+	uint16_t jump;				/*!< Distance change, which resets the filter of a bin. [mm] */
+	uint16_t state[DP_FILTER_BINS];	/*!< Filtered distance of each bin, 0 if empty. [mm/2^DP_FILTER_FRACTION] */
+	uint32_t cycles;			/*!< Maximum measured time of the filter each point. [CPU cycles] */
+} g_filter;
+
+/**
+ * \brief	Spatial filter over the neighbouring points of a turn. The window
+ * 			is a ring buffer, a point is sent when its right neighbour arrives.
+ */
+static struct {
+	uint8_t median;				/*!< TRUE to replace each distance by the median of its neighbourhood. */
+	uint16_t edge;				/*!< Distance step to both neighbours of a mixed pixel, 0 if disabled. [mm] */
+	uint8_t drop;				/*!< TRUE to drop rejected points, FALSE to flag them. */
+	point_t window[DP_SPATIAL_WINDOW];	/*!< Last points of the turn. */
+	uint8_t head;				/*!< Window index of the newest point. */
+	uint8_t count;				/*!< Number of points in the window. */
+	uint32_t cycles;			/*!< Maximum measured time of the evaluation of a point, without sending it. [CPU cycles] */
+} g_spatial;
+
+/**
+ * \brief	TRUE to append the intensity to each point.
+ */
+static uint8_t g_intensityEnable;
+
+/**
+ * \brief	TRUE to send the scan start marker each turn. It is needed by the
+ * 			host with alternating scan profiles or if it asked for it.
+ */
+static uint8_t g_markerEnable;
+
+/**
+ * \brief	Double buffered frames of the scans. One frame is filled, while the
+ * 			gatekeeper sends the other one.
+ */
+static struct {
+	uint8_t enable;				/*!< TRUE to send each scan as one frame. */
+	frame_t buffer[2];			/*!< Both frames. */
+	char data[2][DP_FRAME_LENGTH + 1];	/*!< Storage of the encoded frames. */
+	frame_t *current;			/*!< Frame of the current scan, NULL if the points are sent one by one. */
+	const frame_t *latest;		/*!< Latest complete frame, NULL if there is none. */
+	uint8_t drop;				/*!< TRUE to drop the points of the current scan. */
+	uint32_t overruns;			/*!< Number of dropped frames. */
+} g_frame;
+
+/**
+ * \brief	Delta encoding of the frames. Only the bins, whose distance changed
+ * 			since they were sent the last time, are sent. The reference is the
+ * 			same state as the one of the receiver.
+ */
+static struct {
+	uint8_t keyframe;			/*!< Frames between two keyframes, 0 if disabled. */
+	uint16_t threshold;			/*!< Distance change of a bin, which is sent. [mm] */
+	uint8_t count;				/*!< Frames since the last keyframe. */
+	uint8_t force;				/*!< TRUE if the next frame has to be a keyframe. */
+	int16_t reference[DP_DELTA_BINS];	/*!< Last sent distance of each bin. [mm] */
+	int16_t current[DP_DELTA_BINS];		/*!< Distance of each bin in the current scan. [mm] */
+} g_delta;
+
+/**
+ * \brief	Cartesian coordinates of the points in the vehicle frame. The
+ * 			tables contain the rotation of the sensor.
+ */
+static struct {
+	uint8_t enable;				/*!< TRUE to send the points in Cartesian coordinates. */
+	int16_t x;					/*!< Offset of the sensor in front direction. [mm] */
+	int16_t y;					/*!< Offset of the sensor in left direction. [mm] */
+	int16_t rotation;			/*!< Azimuth of the sensor front in the vehicle frame. [tenth degree] */
+	int16_t cos[DP_CARTESIAN_TABLE];	/*!< Cosine of the azimuth of each increment. [Q15] */
+	int16_t sin[DP_CARTESIAN_TABLE];	/*!< Sine of the azimuth of each increment. [Q15] */
+} g_cartesian;
+
+/**
+ * \brief	Line segment extraction over the points of a scan. The segment
+ * 			grows with each point within the tolerance of its least squares
+ * 			line. The sums are relative to the first point of the segment, so
+ * 			they are exact integers. The encoded segments of a scan are double
+ * 			buffered like the frames.
+ */
+static struct {
+	uint8_t mode;				/*!< DP_LINES_OFF, DP_LINES_ALONGSIDE or DP_LINES_ONLY. */
+	uint16_t tolerance;			/*!< Maximum distance of a point to its line segment. [mm] */
+	uint8_t min_points;			/*!< Fewest points of a line segment. */
+	int32_t x0, y0;				/*!< First point of the segment. [mm] */
+	int32_t dx, dy;				/*!< Last point of the segment, relative to the first one. [mm] */
+	int32_t n;					/*!< Points of the segment. */
+	int64_t sx, sy;				/*!< Sums of the coordinates. */
+	int64_t sxx, syy, sxy;		/*!< Sums of the squared coordinates. */
+	frame_t buffer[2];			/*!< Line segments of the current and the last scan. */
+	char data[2][DP_LINES_LENGTH + 1];	/*!< Storage of the encoded line segments. */
+	frame_t *current;			/*!< Line segments of the current scan, NULL if they are dropped. */
+	const frame_t *latest;		/*!< Line segments of the latest complete scan, NULL if there is none. */
+	uint32_t cycles;			/*!< Extraction time of the current scan. [CPU cycles] */
+	uint32_t max_cycles;		/*!< Maximum extraction time of a scan. [CPU cycles] */
+	uint32_t overruns;			/*!< Number of scans without line segments. */
+} g_lines;
+
+/**
+ * \brief	Protective zones. They are checked with each point before the
+ * 			filters, the alarm bypasses the data stream.
+ */
+static struct {
+	zone_t zone[DP_ZONE_MAX];	/*!< Zone boundaries and ranges. */
+	uint8_t hits[DP_ZONE_MAX];	/*!< Consecutive points within each zone. */
+	uint8_t intruded;			/*!< Zones with an intrusion in the current scan, one bit each zone. */
+	uint8_t alarm;				/*!< Zones with an active alarm, one bit each zone. */
+	uint32_t events;			/*!< Number of raised alarms. */
+	uint32_t dropped;			/*!< Alarm messages lost by a full alarm queue. */
+	uint32_t latency;			/*!< Worst time from the end of the measurement to the alarm. [CPU cycles] */
+} g_zones;
+
+/**
+ * \brief	Learned background of the room. Each bin has the range of the
+ * 			distances while learning, a foreground point is out of this range
+ * 			by more than the tolerance.
+ */
+static struct {
+	uint8_t mode;				/*!< DP_BACKGROUND_OFF, DP_BACKGROUND_POINTS or DP_BACKGROUND_BLOBS. */
+	uint8_t turns;				/*!< Remaining turns to learn the background. */
+	uint16_t tolerance;			/*!< Distance of a foreground point to the background. [mm] */
+	uint8_t learning;			/*!< TRUE while the background is learned. */
+	uint8_t started;			/*!< TRUE after the first scan start while learning. */
+	uint16_t near[DP_BACKGROUND_BINS];	/*!< Nearest distance of each bin, DP_BACKGROUND_EMPTY without an echo. [mm] */
+	uint16_t far[DP_BACKGROUND_BINS];	/*!< Farthest distance of each bin. [mm] */
+	struct {
+		int16_t left;			/*!< Azimuth of the first point. [tenth degree] */
+		int16_t right;			/*!< Azimuth of the last point. [tenth degree] */
+		uint32_t increments;	/*!< Increments of the last point. */
+		int16_t distance;		/*!< Distance of the last point. [mm] */
+		int16_t nearest;		/*!< Nearest distance of the blob. [mm] */
+		uint32_t points;		/*!< Number of points, 0 if there is no blob. */
+	} blob;						/*!< Blob of the adjacent foreground points. */
+} g_background;
+
+/**
+ * \brief	Object tracker. The adjacent foreground points are clustered into
+ * 			objects, which are associated with the tracks at the start of each
+ * 			scan. Each track has a constant velocity filter. The clusters and
+ * 			the tracks are a fixed arena, which bounds the time of a scan.
+ */
+static struct {
+	uint16_t gate;				/*!< Largest distance of an object to its predicted track, 0 if disabled. [mm] */
+	uint8_t misses;				/*!< Scans a track is predicted without an object. */
+	struct {
+		uint32_t increments;	/*!< Increments of the last point. */
+		int16_t distance;		/*!< Distance of the last point. [mm] */
+		int32_t sx, sy;			/*!< Sums of the coordinates. [mm] */
+		int32_t min_x, max_x;	/*!< Bounding box in front direction. [mm] */
+		int32_t min_y, max_y;	/*!< Bounding box in left direction. [mm] */
+		uint32_t points;		/*!< Number of points, 0 if there is no cluster. */
+	} cluster;					/*!< Cluster of the adjacent foreground points. */
+	struct {
+		float x, y;				/*!< Centroid. [mm] */
+		uint16_t extent;		/*!< Larger side of the bounding box. [mm] */
+	} object[DP_CLUSTER_MAX];	/*!< Objects of the current scan. */
+	uint8_t objects;			/*!< Number of objects of the current scan. */
+	struct {
+		uint16_t id;			/*!< Track ID, 0 if the track is free. */
+		float x, y;				/*!< Filtered position. [mm] */
+		float vx, vy;			/*!< Filtered velocity. [mm/s] */
+		uint16_t extent;		/*!< Extent of the last object. [mm] */
+		uint8_t hits;			/*!< Scans with an object, up to DP_TRACK_CONFIRM. */
+		uint8_t missed;			/*!< Consecutive scans without an object. */
+		uint8_t updated;		/*!< TRUE if an object is associated in the current scan. */
+	} track[DP_TRACK_MAX];		/*!< Arena of the tracks. */
+	uint16_t next_id;			/*!< ID of the next new track. */
+	TickType_t tick;			/*!< Tick of the last scan start. */
+	uint8_t scan_id;			/*!< Number of the current turn. */
+	uint8_t profile;			/*!< Scan profile of the current turn. */
+	frame_t buffer[2];			/*!< Objects of the last two scans. */
+	char data[2][DP_OBJECTS_LENGTH + 1];	/*!< Storage of the encoded objects. */
+	const frame_t *latest;		/*!< Objects of the latest scan, NULL if there are none. */
+	uint32_t cycles;			/*!< Tracking time of the current scan. [CPU cycles] */
+	uint32_t max_cycles;		/*!< Maximum tracking time of a scan. [CPU cycles] */
+	uint32_t dropped;			/*!< Objects without a free cluster or track. */
+	uint32_t overruns;			/*!< Number of scans without sent objects. */
+} g_tracker;
+
+/**
+ * \brief	Raw dump of the TDC data. Each record is sent from its own buffer,
+ * 			a record without a free buffer is dropped.
+ */
+static struct {
+	uint8_t enable;				/*!< TRUE to send the raw TDC data instead of the points. */
+	char data[DP_RAW_BUFFERS][DP_RAW_LENGTH + 1];	/*!< Storage of the encoded records. */
+	volatile uint8_t busy[DP_RAW_BUFFERS];	/*!< TRUE while the gatekeeper sends the record. */
+	uint8_t next;				/*!< Buffer of the next record. */
+	uint16_t sequence;			/*!< Number of the next record, the receiver detects the dropped ones. */
+	uint32_t records;			/*!< Number of sent records. */
+	uint32_t dropped;			/*!< Number of dropped records. */
+} g_raw;
+
+/**
+ * \brief	Burst capture of the scans. The frames are stored one after the
+ * 			other, each with its CRC, and sent later over the serial interface.
+ */
+static struct {
+	uint8_t active;				/*!< TRUE from the start of the capture until the controller is told the end. */
+	uint8_t scans;				/*!< Remaining scans to capture. */
+	uint8_t full;				/*!< TRUE if the current scan does not fit into the storage. */
+	frame_t frame;				/*!< Frame of the current scan, its data is NULL before the first scan start. */
+	uint32_t length;			/*!< Used storage by the complete frames. [bytes] */
+	uint32_t frames;			/*!< Number of complete frames. */
+	uint32_t offset[DP_CAPTURE_SCANS_MAX];	/*!< Start of each complete frame in the storage. */
+} g_capture;
+
+/**
+ * \brief	Storage of the burst capture. It is in the CCM RAM, which is not
+ * 			used by any other module.
+ */
+static char g_captureStorage[DP_CAPTURE_LENGTH] __attribute__ ((section (".ccmbss")));
+
+/**
+ * \brief	Statistics of the output of the points. The counters are halved
+ * 			before they overflow, so they weight the recent points.
+ */
+static struct {
+	uint32_t points;			/*!< Number of points. */
+	uint32_t suppressed;		/*!< Points suppressed by the background. */
+	uint32_t cycles;			/*!< Output time of the points. [CPU cycles] */
+} g_output;
+
+/**
+ * \brief	Governor of the data stream. The pressure of the raw data pool and
+ * 			of the serial link raises the level quickly and lowers it slowly,
+ * 			each level degrades the stream further instead of stopping it.
+ */
+static struct {
+	uint8_t enable;				/*!< TRUE to degrade the data stream under load. */
+	uint8_t level;				/*!< Current level, 0 for the full data stream. */
+	uint8_t pressure;			/*!< Latest pressure, the higher one of the pool and the link. [percent] */
+	uint8_t phase;				/*!< Toggles each point, the odd points are decimated. */
+	TickType_t changed;			/*!< Tick of the last level change. */
+	TickType_t high;			/*!< Tick of the last pressure above DP_QOS_LOW. */
+	TickType_t updated;			/*!< Tick of the last update. */
+	uint32_t decimated;			/*!< Number of decimated points. */
+	uint32_t dropped;			/*!< Number of points dropped by a full data queue. */
+} g_qos;
+
+
 /*
  * ----------------------------------------------------------------------------
  * Implementation
@@ -91,8 +437,57 @@ void taskDataProcessingInit(void) {
 	eMemCreateMemoryPool(&memRawData, g_memRawDataStorage,
 			sizeof(rawdata_t), Q_RAWDATA_LENGTH, "Raw Data");
 
-	/* Generate the queue */
+	/* Generate the queues */
 	queueRawDataPtr = xQueueCreate(Q_RAWDATA_LENGTH, sizeof(rawdata_t *));
+	queueDataProcessing = xQueueCreate(Q_DATAPROCESSING_LENGTH, sizeof(dataprocessing_t));
+	queueRawDataFault = xQueueCreate(Q_RAWDATA_FAULT_LENGTH, sizeof(rawdatafault_t));
+
+	/* Create the queue set of the raw data and the settings */
+	queueDataProcessingSet = xQueueCreateSet(Q_RAWDATA_LENGTH + Q_DATAPROCESSING_LENGTH);
+	xQueueAddToSet(queueRawDataPtr, queueDataProcessingSet);
+	xQueueAddToSet(queueDataProcessing, queueDataProcessingSet);
+
+	/* The filters are disabled */
+	memset(&g_filter, 0, sizeof(g_filter));
+	memset(&g_spatial, 0, sizeof(g_spatial));
+	g_intensityEnable = 0;
+	g_markerEnable = 0;
+
+	/* The frames are disabled */
+	memset(&g_frame, 0, sizeof(g_frame));
+	g_frame.buffer[0].data = g_frame.data[0];
+	g_frame.buffer[1].data = g_frame.data[1];
+	memset(&g_delta, 0, sizeof(g_delta));
+
+	/* Polar coordinates, the sensor is in the origin */
+	memset(&g_cartesian, 0, sizeof(g_cartesian));
+	cartesianTable(g_cartesian.cos, g_cartesian.sin, BSP_QUADENC_INC_PER_TURN, g_cartesian.rotation);
+
+	/* The line segments are disabled */
+	memset(&g_lines, 0, sizeof(g_lines));
+	g_lines.buffer[0].data = g_lines.data[0];
+	g_lines.buffer[1].data = g_lines.data[1];
+
+	/* The zones are disabled */
+	memset(&g_zones, 0, sizeof(g_zones));
+
+	/* All points are sent */
+	memset(&g_background, 0, sizeof(g_background));
+	memset(&g_output, 0, sizeof(g_output));
+
+	/* The object tracker is disabled, its arena is empty */
+	memset(&g_tracker, 0, sizeof(g_tracker));
+	g_tracker.buffer[0].data = g_tracker.data[0];
+	g_tracker.buffer[1].data = g_tracker.data[1];
+	g_tracker.next_id = 1;
+
+	/* Nothing is captured, the points are sent instead of the raw data */
+	memset(&g_capture, 0, sizeof(g_capture));
+	memset(&g_raw, 0, sizeof(g_raw));
+
+	/* The governor is enabled, without a degradation */
+	memset(&g_qos, 0, sizeof(g_qos));
+	g_qos.enable = 1;
 }
 
 /**
@@ -101,13 +496,35 @@ void taskDataProcessingInit(void) {
  */
 void taskDataProcessing(void* pvParameters) {
 	rawdata_t *raw_data;
+	QueueSetMemberHandle_t xActivatedMember;
 
 	uint32_t current_cal_resonator = 0;
 	double cal_resonator_factor = 1.0;
 
 	uint32_t i;
+	uint32_t hits;
 	double mean_value;
 
+	dataprocessing_t settings;
+	uint16_t gate_min_mm = 0;
+	uint16_t gate_max_mm = 0;
+	uint32_t raw_min, raw_max;
+	double mm_per_raw;
+	uint8_t walk_mm = 0;
+	uint32_t intensity;
+	uint32_t pulse_width;
+
+	int8_t tcomp[DP_TCOMP_POINTS] = { 0 };
+	uint32_t current_temperature = 0;
+	int16_t offset_tcomp_mm = 0;
+	double resistance;
+	uint32_t cycles;
+	point_t point;
+
+	uint32_t increments;
+	uint8_t scan_id, profile;
+	uint8_t raw_data_calibrate;
+	uint32_t raw_data_cycles;
 	int16_t azimuth;
 	int16_t distance_mm;
 	int16_t distance_offset_mm = 0;
@@ -118,21 +535,228 @@ void taskDataProcessing(void* pvParameters) {
 
 	/* Loop forever */
 	for (;;) {
+		/* Wait for new raw data or new configuration settings. The settings
+		 * are also taken over in the command mode, without any raw data */
+		xActivatedMember = xQueueSelectFromSet(queueDataProcessingSet, portMAX_DELAY);
+
+		/* Take over new configuration settings */
+		if (xActivatedMember == queueDataProcessing
+				&& xQueueReceive(queueDataProcessing, &settings, 0) == pdTRUE) {
+			switch (settings.config) {
+			case DATA_PROCESSING_GATE:
+				gate_min_mm = settings.param.gate.min;
+				gate_max_mm = settings.param.gate.max;
+				break;
+
+			case DATA_PROCESSING_INTENSITY:
+				g_intensityEnable = settings.param.intensity;
+				break;
+
+			case DATA_PROCESSING_WALK:
+				walk_mm = settings.param.walk;
+				break;
+
+			case DATA_PROCESSING_FILTER:
+				g_filter.shift = settings.param.filter.shift;
+				g_filter.jump = settings.param.filter.jump;
+				memset(g_filter.state, 0, sizeof(g_filter.state));
+				break;
+
+			case DATA_PROCESSING_SPATIAL:
+				spatialFlush();
+				g_spatial.median = settings.param.spatial.median;
+				g_spatial.edge = settings.param.spatial.edge;
+				g_spatial.drop = settings.param.spatial.drop;
+				break;
+
+			case DATA_PROCESSING_FRAME:
+				g_frame.enable = settings.param.frame;
+				g_frame.current = NULL;
+				g_frame.drop = 0;
+				break;
+
+			case DATA_PROCESSING_DELTA:
+				g_delta.keyframe = settings.param.delta.keyframe;
+				g_delta.threshold = settings.param.delta.threshold;
+				g_delta.force = 1;
+				g_frame.current = NULL;
+				g_frame.drop = 0;
+				break;
+
+			case DATA_PROCESSING_CARTESIAN:
+				g_cartesian.enable = settings.param.cartesian;
+				break;
+
+			case DATA_PROCESSING_MOUNT:
+				g_cartesian.x = settings.param.mount.x;
+				g_cartesian.y = settings.param.mount.y;
+				if (g_cartesian.rotation != settings.param.mount.rotation) {
+					g_cartesian.rotation = settings.param.mount.rotation;
+					cartesianTable(g_cartesian.cos, g_cartesian.sin, BSP_QUADENC_INC_PER_TURN, g_cartesian.rotation);
+				}
+				break;
+
+			case DATA_PROCESSING_LINES:
+				g_lines.mode = settings.param.lines.mode;
+				g_lines.tolerance = settings.param.lines.tolerance;
+				g_lines.min_points = settings.param.lines.points;
+				g_lines.current = NULL;
+				break;
+
+			case DATA_PROCESSING_ZONE:
+				if (settings.param.zone.index < DP_ZONE_MAX) {
+					g_zones.zone[settings.param.zone.index] = settings.param.zone.zone;
+					g_zones.hits[settings.param.zone.index] = 0;
+				}
+				break;
+
+			case DATA_PROCESSING_BACKGROUND:
+				g_background.mode = settings.param.background.mode;
+				g_background.turns = settings.param.background.turns;
+				g_background.tolerance = settings.param.background.tolerance;
+				g_background.learning = (g_background.mode != DP_BACKGROUND_OFF);
+				g_background.started = 0;
+				g_background.blob.points = 0;
+				for (i=0; i<DP_BACKGROUND_BINS; i++) {
+					g_background.near[i] = DP_BACKGROUND_EMPTY;
+					g_background.far[i] = 0;
+				}
+				break;
+
+			case DATA_PROCESSING_TRACKER:
+				g_tracker.gate = settings.param.tracker.gate;
+				g_tracker.misses = settings.param.tracker.misses;
+				g_tracker.cluster.points = 0;
+				g_tracker.objects = 0;
+				for (i=0; i<DP_TRACK_MAX; i++) {
+					g_tracker.track[i].id = 0;
+				}
+				break;
+
+			case DATA_PROCESSING_RAW:
+				g_raw.enable = settings.param.raw;
+				break;
+
+			case DATA_PROCESSING_CAPTURE:
+				/* A new capture overwrites the last one, the captured frames are kept after a stop */
+				if (settings.param.capture) {
+					g_capture.length = 0;
+					g_capture.frames = 0;
+				}
+				g_capture.active = (settings.param.capture > 0);
+				g_capture.scans = settings.param.capture;
+				g_capture.full = 0;
+				g_capture.frame.data = NULL;
+				g_frame.current = NULL;
+				g_frame.drop = 0;
+				g_lines.current = NULL;
+				break;
+
+			case DATA_PROCESSING_QOS:
+				g_qos.enable = settings.param.qos;
+				g_qos.level = 0;
+				taskDataAcquisitionSetQos(0);
+				break;
+
+			case DATA_PROCESSING_MARKER:
+				g_markerEnable = settings.param.marker;
+				break;
+
+			case DATA_PROCESSING_TCOMP:
+				if (settings.param.tcomp.index < DP_TCOMP_POINTS) {
+					tcomp[settings.param.tcomp.index] = settings.param.tcomp.value;
+				}
+				break;
+			}
+		}
+
 		/* Get the new raw data from data acquisition */
-		if (xQueueReceive(queueRawDataPtr, &raw_data, portMAX_DELAY) == pdTRUE) {
+		if (xActivatedMember == queueRawDataPtr
+				&& xQueueReceive(queueRawDataPtr, &raw_data, 0) == pdTRUE) {
+			/* Adapt the data stream to the load */
+			if (g_qos.enable) {
+				qosUpdate();
+			}
+
+			/* Raw dump: the TDC data is sent instead of the point, it has no
+			 * fault markers */
+			if (g_raw.enable) {
+				xQueueReset(queueRawDataFault);
+				rawDump(raw_data);
+				eMemGiveBlock(&memRawData, raw_data);
+				continue;
+			}
+
 			/* Calculate the new calibration factor if necessary */
 			if (raw_data->cal_resonator != current_cal_resonator) {
 				cal_resonator_factor = (BSP_GP22_RESONATOR_CYCLE / BSP_GP22_RESONATOR) / (1.0 / BSP_GP22_HS_CRYSTAL * raw_data->cal_resonator / (double) 0xFFFF);
 				current_cal_resonator = raw_data->cal_resonator;
 			}
 
-			if (raw_data->raw_ctr > raw_data->expected_points / 2) {
-				/* Calculate the mean value */
-				mean_value = 0.0;
-				for (i=0; i<raw_data->raw_ctr; i++) {
+			/* Calculate the new temperature of the PT1000 sensor if necessary */
+			if (raw_data->temperature != 0 && raw_data->temperature != current_temperature) {
+				resistance = raw_data->temperature / 65536.0 * BSP_GP22_TEMP_RREF;
+				g_temperature = (resistance / BSP_GP22_TEMP_R0 - 1.0) / BSP_GP22_TEMP_ALPHA * 10.0;
+				current_temperature = raw_data->temperature;
+			}
+
+			/* Calculate the azimuth [tenth degree] */
+			increments = raw_data->increments;
+			azimuth = increments2tenthdegree(increments);
+			scan_id = raw_data->scan_id;
+			profile = raw_data->profile;
+			raw_data_calibrate = raw_data->calibrate;
+			raw_data_cycles = raw_data->cycles;
+
+			/* Range gate in raw values, but not for the calibration on the reference mark */
+			raw_min = 0;
+			raw_max = 0xFFFFFFFF;
+			if (azimuth != DA_AZIMUTH_CAL_DIST && (gate_min_mm || gate_max_mm)) {
+				mm_per_raw = UINT_FACTOR * VERILOG_OF_LIGHT / 2.0 * cal_resonator_factor / BSP_GP22_HS_CRYSTAL / (double) 0xFFFF;
+				if (gate_min_mm) {
+					raw_min = (gate_min_mm + distance_offset_mm) / mm_per_raw;
+				}
+				if (gate_max_mm) {
+					raw_max = (gate_max_mm + distance_offset_mm) / mm_per_raw;
+				}
+			}
+
+			/* Sum of the hits within the range gate */
+			mean_value = 0.0;
+			hits = 0;
+			for (i=0; i<raw_data->raw_ctr; i++) {
+				if (raw_data->raw[i] >= raw_min && raw_data->raw[i] <= raw_max) {
 					mean_value += raw_data->raw[i];
+					hits++;
+				}
+			}
+
+			/* Hit statistics of the room map points */
+			if (azimuth != DA_AZIMUTH_CAL_DIST) {
+				if (g_hits.expected > 0x40000000) {
+					g_hits.expected /= 2;
+					g_hits.received /= 2;
+					g_hits.points /= 2;
+					g_hits.valid /= 2;
+					for (i=0; i<DP_HITS_CLASSES; i++) {
+						g_hits.bins[i] /= 2;
+					}
 				}
-				mean_value += (raw_data->expected_points - raw_data->raw_ctr) * (1.5 * 39375);
+				g_hits.expected += raw_data->expected_points;
+				g_hits.received += hits;
+				g_hits.points++;
+				if (hits > raw_data->expected_points / 2) {
+					g_hits.valid++;
+				}
+
+				/* Hits of this bin, a full bin is in the last class */
+				i = raw_data->expected_points ? hits * DP_HITS_CLASSES / raw_data->expected_points : 0;
+				g_hits.bins[(i < DP_HITS_CLASSES) ? i : DP_HITS_CLASSES - 1]++;
+			}
+
+			if (hits > raw_data->expected_points / 2) {
+				/* Calculate the mean value */
+				mean_value += (raw_data->expected_points - hits) * (1.5 * 39375);
 				mean_value = mean_value / raw_data->expected_points;
 			}
 			else {
@@ -140,8 +764,16 @@ void taskDataProcessing(void* pvParameters) {
 				mean_value = 0x7FFFFFFF;
 			}
 
-			/* Calculate the azimuth [tenth degree] */
-			azimuth = increments2tenthdegree(raw_data->increments);
+			/* Intensity of the point. The hit ratio is weighted with the pulse width,
+			 * if the TDC measured it */
+			pulse_width = raw_data->pulse_width ? raw_data->pulse_width : DP_PULSE_WIDTH_UNIT;
+			intensity = 0;
+			if (raw_data->expected_points > 0) {
+				intensity = (uint64_t) hits * DP_INTENSITY_UNIT * pulse_width / DP_PULSE_WIDTH_UNIT / raw_data->expected_points;
+			}
+			if (intensity > DP_INTENSITY_MAX) {
+				intensity = DP_INTENSITY_MAX;
+			}
 
 			/* Give the memory block */
 			eMemGiveBlock(&memRawData, raw_data);
@@ -164,20 +796,109 @@ void taskDataProcessing(void* pvParameters) {
 
 			/* Check if it is a offset correction measurement or a data point of the room map */
 			if (azimuth == DA_AZIMUTH_CAL_DIST) {
-				/* Set the new calibration offset */
-				distance_offset_mm = distance_mm - DA_DISTANCE_CAL;
+				if (raw_data_calibrate) {
+					/* Set the new calibration offset at the current temperature */
+					distance_offset_mm = distance_mm - DA_DISTANCE_CAL;
+					offset_tcomp_mm = temperatureCorrection(tcomp, g_temperature);
+				}
+
+				/* The alarms of the zones without an intrusion in the last turn are cleared */
+				zonesScan();
+
+				/* The last point of the turn has no right neighbour */
+				spatialFlush();
+
+				/* The points lost after the last point of the previous turns */
+				faultMarkers(scan_id, 0);
+
+				if (g_capture.active) {
+					/* Burst capture: the turn is stored instead of sent */
+					captureScan(scan_id, profile);
+				}
+				else {
+					/* The last blob of the turn, and the turns to learn the background */
+					backgroundScan();
+
+					if (g_tracker.gate) {
+						/* Track the objects of the last turn and send them */
+						trackerScan(scan_id, profile);
+					}
+
+					if (g_lines.mode != DP_LINES_OFF) {
+						/* It is the first point of a turn: Send the line segments of the last turn */
+						linesComplete();
+						linesStart(scan_id, profile);
+					}
+
+					if (g_lines.mode == DP_LINES_ONLY) {
+						/* The line segments have the scan marker */
+					}
+					else if (g_frame.enable) {
+						/* It is the first point of a turn: Send the frame of the last turn */
+						frameComplete();
+						frameStart(scan_id, profile);
+					}
+					else if (g_markerEnable) {
+						/* It is the first point of a turn: Send the scan start marker */
+						dataEncode(DP_AZIMUTH_SCAN, (profile << 8) | scan_id, room_map_point);
+						room_map_point[4] = '\0';
+						xQueueSend(queueMessageData, room_map_point, portMAX_DELAY);
+					}
+				}
 			}
 			else {
 				/* Offset correction only by a true distance value */
 				if (distance_mm != 0xFFF) {
 					distance_mm = distance_mm - distance_offset_mm;
+
+					/* Temperature drift since the last calibration */
+					distance_mm -= temperatureCorrection(tcomp, g_temperature) - offset_tcomp_mm;
+
+					/* Weak echoes cross the threshold later (walk error) */
+					if (walk_mm && intensity < DP_INTENSITY_UNIT) {
+						distance_mm -= (int32_t) walk_mm * (DP_INTENSITY_UNIT - intensity) / DP_INTENSITY_UNIT;
+					}
+
+					/* A close echo stays valid, the negative distances are DP_DISTANCE_REJECTED */
+					if (distance_mm < 0) {
+						distance_mm = 0;
+					}
+				}
+
+				/* Protective zones, before the filters delay an intrusion */
+				zonesCheck(azimuth, distance_mm, raw_data_cycles);
+
+				/* Filter the distance over the turns */
+				if (g_filter.shift) {
+					cycles = DWT->CYCCNT;
+					distance_mm = temporalFilter(increments, distance_mm);
+					cycles = DWT->CYCCNT - cycles;
+					if (cycles > g_filter.cycles) {
+						g_filter.cycles = cycles;
+					}
 				}
 
-				/* Encode the data of the point of the room map */
-				dataEncode(azimuth, distance_mm, room_map_point);
+				/* Feed back the distance to the range adaptive sampling, without
+				 * an echo the distance is unknown (0) */
+				if (distance_mm == DP_DISTANCE_REJECTED || distance_mm >= 0xFFF) {
+					taskDataAcquisitionSetRange(increments, 0);
+				}
+				else {
+					taskDataAcquisitionSetRange(increments, distance_mm);
+				}
 
-				/* Send the calculated result to the gatekeeper task */
-				xQueueSend(queueMessageData, room_map_point, portMAX_DELAY);
+				/* Send the point of the room map, over the spatial filter */
+				point.increments = increments;
+				point.scan_id = scan_id;
+				point.azimuth = azimuth;
+				point.distance = distance_mm;
+				point.intensity = intensity;
+				if (g_spatial.median || g_spatial.edge) {
+					spatialFilter(&point);
+				}
+				else {
+					sendPoint(&point);
+				}
 			}
 
 		}
@@ -186,6 +907,1507 @@ void taskDataProcessing(void* pvParameters) {
 	/* Never reach this point */
 }
 
+/**
+ * \brief	Gets the last measured temperature of the TDC.
+ * \return	Temperature, 0 if not measured yet. [tenth degree Celsius]
+ */
+int16_t taskDataProcessingGetTemperature(void) {
+	return g_temperature;
+}
+
+/**
+ * \brief	Gets the maximum measured costs of the filters each point.
+ * \param[out]	temporal_ns is the time of the temporal filter. [ns]
+ * \param[out]	spatial_ns is the time of the spatial filter, without the
+ * 				sending of the point. [ns]
+ */
+void taskDataProcessingFilterCost(uint32_t *temporal_ns, uint32_t *spatial_ns) {
+	*temporal_ns = (uint64_t) g_filter.cycles * 1000000000ULL / SystemCoreClock;
+	*spatial_ns = (uint64_t) g_spatial.cycles * 1000000000ULL / SystemCoreClock;
+}
+
+/**
+ * \brief	Gets the hit statistics of the room map points.
+ * \param[out]	hit_ratio is the ratio of the received to the expected TDC hits. [per mill]
+ * \param[out]	valid_ratio is the ratio of the points with a valid distance. [per mill]
+ */
+void taskDataProcessingGetHits(uint32_t *hit_ratio, uint32_t *valid_ratio) {
+	*hit_ratio = g_hits.expected ? (uint64_t) g_hits.received * 1000 / g_hits.expected : 0;
+	*valid_ratio = g_hits.points ? (uint64_t) g_hits.valid * 1000 / g_hits.points : 0;
+}
+
+/**
+ * \brief	Gets the per bin hit statistics. Each bin (point) is counted in
+ * 			the class of its received hits, in quarters of the expected hits.
+ * \param[out]	bins is the share of the bins in each of the DP_HITS_CLASSES
+ * 				classes, the lowest quarter first. [per mill]
+ */
+void taskDataProcessingGetBins(uint32_t *bins) {
+	uint8_t i;
+
+	for (i=0; i<DP_HITS_CLASSES; i++) {
+		bins[i] = g_hits.points ? (uint64_t) g_hits.bins[i] * 1000 / g_hits.points : 0;
+	}
+}
+
+
+/**
+ * \brief	Distance correction of a temperature. It is linear interpolated
+ * 			between the points of the correction table.
+ * \param[in]	table is the correction table, starting at DP_TCOMP_MIN. [mm]
+ * \param[in]	temperature is the current temperature. [tenth degree Celsius]
+ * \return	Distance correction. [mm]
+ */
+int16_t temperatureCorrection(const int8_t *table, int16_t temperature) {
+	int32_t position = temperature - DP_TCOMP_MIN * 10;
+	int32_t index = position / (DP_TCOMP_STEP * 10);
+
+	/* Hold the values outside of the table */
+	if (position <= 0) {
+		return table[0];
+	}
+	if (index >= DP_TCOMP_POINTS - 1) {
+		return table[DP_TCOMP_POINTS - 1];
+	}
+
+	return table[index] + (table[index+1] - table[index]) * (position % (DP_TCOMP_STEP * 10)) / (DP_TCOMP_STEP * 10);
+}
+
+
+/**
+ * \brief	Exponential moving average of the distance of an azimuth bin over
+ * 			the turns. A large distance change resets the bin, so moving
+ * 			objects are not smeared.
+ * \param[in]	increments is the azimuth of the point. [increments]
+ * \param[in]	distance is the measured distance. [mm]
+ * \return	Filtered distance. [mm]
+ */
+int16_t temporalFilter(uint32_t increments, int16_t distance) {
+	uint16_t *state = &g_filter.state[(increments / DP_FILTER_BIN_INC) % DP_FILTER_BINS];
+	int32_t input;
+
+	/* No reflection: the bin starts again with the next valid distance */
+	if (distance == 0xFFF || distance < 0) {
+		*state = 0;
+		return distance;
+	}
+
+	input = (int32_t) distance << DP_FILTER_FRACTION;
+	if (*state == 0 || abs(input - *state) > ((int32_t) g_filter.jump << DP_FILTER_FRACTION)) {
+		/* First distance or a jump */
+		*state = input;
+	}
+	else {
+		/* state += (input - state) / 2^shift */
+		*state += (input - *state) >> g_filter.shift;
+	}
+
+	return (*state + (1 << (DP_FILTER_FRACTION-1))) >> DP_FILTER_FRACTION;
+}
+
+
+/**
+ * \brief	Adds a point to the spatial filter. The previous point is sent, as
+ * 			soon as both of its neighbours are known.
+ * \param[in]	point is the new point of the turn.
+ */
+void spatialFilter(const point_t *point) {
+	uint8_t previous = g_spatial.head;
+	point_t filtered;
+	uint32_t cycles;
+	uint8_t send;
+
+	/* Add the point to the ring buffer */
+	g_spatial.head = (g_spatial.head + 1) % DP_SPATIAL_WINDOW;
+	g_spatial.window[g_spatial.head] = *point;
+	if (g_spatial.count < DP_SPATIAL_WINDOW) {
+		g_spatial.count++;
+	}
+
+	if (g_spatial.count == 2) {
+		/* The first point of the turn has no left neighbour */
+		sendPoint(&g_spatial.window[previous]);
+	}
+	else if (g_spatial.count == DP_SPATIAL_WINDOW) {
+		/* Evaluate the middle point of the window, its time without the output */
+		cycles = DWT->CYCCNT;
+		send = spatialEvaluate(&g_spatial.window[(previous + DP_SPATIAL_WINDOW - 1) % DP_SPATIAL_WINDOW],
+				&g_spatial.window[previous], &g_spatial.window[g_spatial.head], &filtered);
+		cycles = DWT->CYCCNT - cycles;
+		if (cycles > g_spatial.cycles) {
+			g_spatial.cycles = cycles;
+		}
+
+		if (send) {
+			sendPoint(&filtered);
+		}
+	}
+}
+
+/**
+ * \brief	Sends the last point of the spatial filter without a right neighbour
+ * 			and empties the window.
+ */
+void spatialFlush(void) {
+	if (g_spatial.count > 0) {
+		sendPoint(&g_spatial.window[g_spatial.head]);
+	}
+	g_spatial.count = 0;
+}
+
+/**
+ * \brief	Filters a point with its neighbours. A point between two distance
+ * 			steps is a mixed pixel of an edge and rejected. Otherwise its
+ * 			distance is replaced by the median of the three points.
+ * \param[in]	previous is the left neighbour.
+ * \param[in]	current is the point to filter.
+ * \param[in]	next is the right neighbour.
+ * \param[out]	point is the filtered point.
+ * \return	FALSE if the point is dropped.
+ */
+uint8_t spatialEvaluate(const point_t *previous, const point_t *current, const point_t *next, point_t *point) {
+	int16_t a = previous->distance;
+	int16_t b = current->distance;
+	int16_t c = next->distance;
+
+	*point = *current;
+
+	/* Only neighbouring azimuths are a neighbourhood, not the next scan sector */
+	if ((current->increments - previous->increments + BSP_QUADENC_INC_PER_TURN+1) % (BSP_QUADENC_INC_PER_TURN+1) > DP_SPATIAL_GAP_INC
+			|| (next->increments - current->increments + BSP_QUADENC_INC_PER_TURN+1) % (BSP_QUADENC_INC_PER_TURN+1) > DP_SPATIAL_GAP_INC) {
+		return 1;
+	}
+
+	if (g_spatial.edge && a != 0xFFF && b != 0xFFF && c != 0xFFF
+			&& ((a < b && b < c) || (a > b && b > c))
+			&& abs(b - a) > g_spatial.edge && abs(c - b) > g_spatial.edge) {
+		/* Mixed pixel between a foreground and a background */
+		if (g_spatial.drop) {
+			return 0;
+		}
+		point->distance = DP_DISTANCE_REJECTED;
+	}
+	else if (g_spatial.median) {
+		/* Median of three */
+		if ((a <= b && b <= c) || (c <= b && b <= a)) {
+			point->distance = b;
+		}
+		else if ((b <= a && a <= c) || (c <= a && a <= b)) {
+			point->distance = a;
+		}
+		else {
+			point->distance = c;
+		}
+	}
+
+	return 1;
+}
+
+/**
+ * \brief	Sends a point of the room map to the output stages and measures
+ * 			their time. The wait for the gatekeeper task is not measured.
+ * \param[in]	point is the processed point.
+ */
+void sendPoint(const point_t *point) {
+	char room_map_point[DATA_MESSAGE_STRING_LENGTH];
+	uint32_t cycles = DWT->CYCCNT;
+	uint32_t length;
+
+	/* The points lost before this one */
+	faultMarkers(point->scan_id, point->increments);
+
+	length = outputPoint(point, room_map_point);
+
+	if (g_output.points > 0x40000000 || g_output.cycles > 0x40000000) {
+		g_output.points /= 2;
+		g_output.suppressed /= 2;
+		g_output.cycles /= 2;
+	}
+	g_output.points++;
+	g_output.cycles += DWT->CYCCNT - cycles;
+
+	/* Send the calculated result to the gatekeeper task. The governor drops
+	 * the point instead of waiting for a full queue */
+	if (length > 0 && xQueueSend(queueMessageData, room_map_point, g_qos.enable ? 0 : portMAX_DELAY) != pdTRUE) {
+		g_qos.dropped++;
+	}
+}
+
+/**
+ * \brief	Encodes a point of the room map for the gatekeeper task, or appends
+ * 			it to the frame of the current scan.
+ * \param[in]	point is the processed point.
+ * \param[out]	room_map_point is a storage address of DATA_MESSAGE_STRING_LENGTH
+ * 				bytes for the encoded point.
+ * \return	Length of the encoded point to send, 0 if nothing is sent.
+ */
+uint32_t outputPoint(const point_t *point, char *room_map_point) {
+	frame_t *frame = g_frame.current;
+	uint32_t length;
+
+	/* Burst capture, nothing is sent */
+	if (g_capture.active) {
+		capturePoint(point);
+		return 0;
+	}
+
+	/* Object tracking, independent of the sent points */
+	if (g_tracker.gate) {
+		trackerPoint(point);
+	}
+
+	/* Line segment extraction */
+	if (g_lines.mode != DP_LINES_OFF) {
+		linesAdd(point);
+		if (g_lines.mode == DP_LINES_ONLY) {
+			return 0;
+		}
+	}
+
+	/* Only the changes to the background */
+	if (g_background.mode != DP_BACKGROUND_OFF && !backgroundPoint(point)) {
+		g_output.suppressed++;
+		return 0;
+	}
+
+	/* The frame of this scan was dropped */
+	if (g_frame.drop) {
+		return 0;
+	}
+
+	/* Keep the distance of the bin, the frame is encoded at the end of the scan */
+	if (frame != NULL && g_delta.keyframe) {
+		g_delta.current[point->increments / DP_DELTA_BIN_INC] = (point->distance == DP_DISTANCE_REJECTED) ? 0 : point->distance;
+		return 0;
+	}
+
+	/* A point without a distance has no Cartesian coordinates */
+	if (g_cartesian.enable && (point->distance == DP_DISTANCE_REJECTED || point->distance >= 0xFFF)) {
+		return 0;
+	}
+
+	/* The governor sends every second point under load */
+	if (g_qos.level >= DP_QOS_DECIMATE && (g_qos.phase ^= 1)) {
+		g_qos.decimated++;
+		return 0;
+	}
+
+	/* Append the point to the frame */
+	if (frame != NULL) {
+		if (frame->length + DATA_MESSAGE_STRING_LENGTH <= DP_FRAME_LENGTH) {
+			frame->length += encodePoint(point, &frame->data[frame->length]);
+			frame->points++;
+		}
+		return 0;
+	}
+
+	/* Encode the data of the point of the room map */
+	length = encodePoint(point, room_map_point);
+	if (length < DATA_MESSAGE_STRING_LENGTH) {
+		room_map_point[length] = '\0';
+	}
+
+	return length;
+}
+
+/**
+ * \brief	Encodes a point of the room map, in polar or Cartesian coordinates
+ * 			and with or without the intensity.
+ * \param[in]	point is the processed point.
+ * \param[out]	base64 is a storage address of DATA_MESSAGE_STRING_LENGTH bytes for the encoded point.
+ * \return	Number of encoded characters.
+ */
+uint32_t encodePoint(const point_t *point, char *base64) {
+	uint32_t length;
+	int32_t x, y;
+
+	if (g_cartesian.enable) {
+		cartesianPoint(point, &x, &y);
+		dataEncodeValue(x, DP_CARTESIAN_DIGITS, base64);
+		dataEncodeValue(y, DP_CARTESIAN_DIGITS, &base64[DP_CARTESIAN_DIGITS]);
+		length = 2 * DP_CARTESIAN_DIGITS;
+	}
+	else {
+		dataEncode(point->azimuth, (point->distance == DP_DISTANCE_REJECTED) ? 0 : point->distance, base64);
+		length = 4;
+	}
+
+	if (g_intensityEnable) {
+		dataEncodeIntensity(point->intensity, &base64[length]);
+		length += 2;
+	}
+
+	return length;
+}
+
+/**
+ * \brief	Cartesian coordinates of a point in the vehicle frame.
+ * \param[in]	point is the processed point.
+ * \param[out]	x is the coordinate in front direction. [mm]
+ * \param[out]	y is the coordinate in left direction. [mm]
+ */
+void cartesianPoint(const point_t *point, int32_t *x, int32_t *y) {
+	/* Rotation over the tables, then the offset of the sensor */
+	cartesianRotate(g_cartesian.cos, g_cartesian.sin, point->distance, point->increments, x, y);
+	*x += g_cartesian.x;
+	*y += g_cartesian.y;
+}
+
+/**
+ * \brief	Starts the line segments of a new scan in the buffer, which is not
+ * 			used by the latest line segments. They are dropped if the
+ * 			gatekeeper still sends this buffer.
+ * \param[in]	scan_id is the number of the turn.
+ * \param[in]	profile is the scan profile of the turn.
+ */
+void linesStart(uint8_t scan_id, uint8_t profile) {
+	frame_t *lines;
+
+	/* Take the other buffer than the latest line segments */
+	lines = (g_lines.latest == &g_lines.buffer[0]) ? &g_lines.buffer[1] : &g_lines.buffer[0];
+
+	g_lines.n = 0;
+	g_lines.cycles = 0;
+	if (lines->busy) {
+		/* The serial interface is too slow for the line segments */
+		g_lines.current = NULL;
+		g_lines.overruns++;
+		return;
+	}
+
+	lines->scan_id = scan_id;
+	lines->profile = profile;
+	lines->points = 0;
+	lines->start = xTaskGetTickCount();
+	lines->end = lines->start;
+	lines->length = DP_LINES_HEADER_LENGTH;
+	g_lines.current = lines;
+}
+
+/**
+ * \brief	Adds a point to the line segment. The segment is completed if the
+ * 			point has no distance, has a gap to the last point or is out of the
+ * 			tolerance of the line, and a new segment starts with the point.
+ * \param[in]	point is the processed point.
+ */
+void linesAdd(const point_t *point) {
+	uint32_t cycles = DWT->CYCCNT;
+	int32_t x, y, dx, dy;
+	float a, b, c, lambda, nx, ny, distance;
+
+	/* Stop the extraction of this scan after its CPU time budget */
+	if (g_lines.current == NULL || g_lines.cycles > (uint64_t) DP_LINES_BUDGET_US * SystemCoreClock / 1000000) {
+		return;
+	}
+
+	if (point->distance == DP_DISTANCE_REJECTED || point->distance >= 0xFFF) {
+		/* A point without a distance interrupts the segment */
+		linesSegment();
+		g_lines.n = 0;
+	}
+	else {
+		cartesianPoint(point, &x, &y);
+		dx = x - g_lines.x0;
+		dy = y - g_lines.y0;
+
+		if (g_lines.n > 0) {
+			/* Gap to the last point */
+			if ((int64_t) (dx - g_lines.dx) * (dx - g_lines.dx) + (int64_t) (dy - g_lines.dy) * (dy - g_lines.dy)
+					> (int64_t) DP_LINES_GAP * DP_LINES_GAP) {
+				linesSegment();
+				g_lines.n = 0;
+			}
+		}
+
+		if (g_lines.n > 1) {
+			/* Normal of the least squares line, the covariances are scaled by n^2 */
+			a = (float) (g_lines.n * g_lines.sxx - g_lines.sx * g_lines.sx);
+			b = (float) (g_lines.n * g_lines.sxy - g_lines.sx * g_lines.sy);
+			c = (float) (g_lines.n * g_lines.syy - g_lines.sy * g_lines.sy);
+			lambda = (a + c) / 2.0f - sqrtf((a - c) * (a - c) / 4.0f + b * b);
+			if (fabsf(lambda - a) > fabsf(lambda - c)) {
+				nx = b;
+				ny = lambda - a;
+			}
+			else {
+				nx = lambda - c;
+				ny = b;
+			}
+
+			/* Distance of the point to the line */
+			distance = ((float) (g_lines.n * dx - g_lines.sx) * nx + (float) (g_lines.n * dy - g_lines.sy) * ny) / g_lines.n;
+			if (distance * distance > (float) g_lines.tolerance * g_lines.tolerance * (nx * nx + ny * ny)) {
+				linesSegment();
+				g_lines.n = 0;
+			}
+		}
+
+		if (g_lines.n == 0) {
+			/* First point of a new segment */
+			g_lines.x0 = x;
+			g_lines.y0 = y;
+			dx = 0;
+			dy = 0;
+			g_lines.sx = 0;
+			g_lines.sy = 0;
+			g_lines.sxx = 0;
+			g_lines.syy = 0;
+			g_lines.sxy = 0;
+		}
+
+		g_lines.n++;
+		g_lines.dx = dx;
+		g_lines.dy = dy;
+		g_lines.sx += dx;
+		g_lines.sy += dy;
+		g_lines.sxx += (int64_t) dx * dx;
+		g_lines.syy += (int64_t) dy * dy;
+		g_lines.sxy += (int64_t) dx * dy;
+	}
+
+	g_lines.cycles += DWT->CYCCNT - cycles;
+}
+
+/**
+ * \brief	Fits the least squares line to the points of the segment and
+ * 			appends it to the line segments of the scan. The endpoints are the
+ * 			first and the last point, projected on the line.
+ */
+void linesSegment(void) {
+	frame_t *lines = g_lines.current;
+	float n, mx, my, a, b, c, lambda, ux, uy, norm, t;
+	int32_t residual;
+	char *ptr;
+
+	if (lines == NULL || g_lines.n < g_lines.min_points
+			|| lines->length + DP_LINE_LENGTH > DP_LINES_LENGTH) {
+		return;
+	}
+
+	/* Centroid and covariances */
+	n = g_lines.n;
+	mx = g_lines.sx / n;
+	my = g_lines.sy / n;
+	a = (float) (g_lines.n * g_lines.sxx - g_lines.sx * g_lines.sx) / (n * n);
+	b = (float) (g_lines.n * g_lines.sxy - g_lines.sx * g_lines.sy) / (n * n);
+	c = (float) (g_lines.n * g_lines.syy - g_lines.sy * g_lines.sy) / (n * n);
+	lambda = (a + c) / 2.0f - sqrtf((a - c) * (a - c) / 4.0f + b * b);
+
+	/* Direction of the line, the eigenvector of the largest eigenvalue */
+	if (fabsf(lambda - a) > fabsf(lambda - c)) {
+		ux = -(lambda - a);
+		uy = b;
+	}
+	else {
+		ux = -b;
+		uy = lambda - c;
+	}
+	norm = sqrtf(ux * ux + uy * uy);
+	if (norm == 0.0f) {
+		ux = g_lines.dx;
+		uy = g_lines.dy;
+		norm = sqrtf(ux * ux + uy * uy);
+	}
+	ux /= norm;
+	uy /= norm;
+
+	/* Root mean square distance of the points to the line [tenth mm] */
+	residual = sqrtf(lambda > 0.0f ? lambda : 0.0f) * 10.0f + 0.5f;
+	if (residual > 0xFFF) {
+		residual = 0xFFF;
+	}
+
+	/* Both endpoints */
+	ptr = &lines->data[lines->length];
+	t = -mx * ux - my * uy;
+	dataEncodeValue(lroundf(g_lines.x0 + mx + t * ux), DP_CARTESIAN_DIGITS, &ptr[0]);
+	dataEncodeValue(lroundf(g_lines.y0 + my + t * uy), DP_CARTESIAN_DIGITS, &ptr[3]);
+	t = (g_lines.dx - mx) * ux + (g_lines.dy - my) * uy;
+	dataEncodeValue(lroundf(g_lines.x0 + mx + t * ux), DP_CARTESIAN_DIGITS, &ptr[6]);
+	dataEncodeValue(lroundf(g_lines.y0 + my + t * uy), DP_CARTESIAN_DIGITS, &ptr[9]);
+	dataEncodeValue(residual, 2, &ptr[12]);
+	dataEncodeValue((g_lines.n > 0xFFF) ? 0xFFF : g_lines.n, 2, &ptr[14]);
+
+	lines->length += DP_LINE_LENGTH;
+	lines->points++;
+}
+
+/**
+ * \brief	Completes the line segments of the current scan with its header
+ * 			and sends them to the gatekeeper task as one message.
+ */
+void linesComplete(void) {
+	frame_t *lines = g_lines.current;
+	messageblock_t message;
+
+	/* The line segments of this scan were dropped */
+	if (lines == NULL) {
+		return;
+	}
+
+	/* The last segment of the scan */
+	linesSegment();
+	g_lines.current = NULL;
+	if (g_lines.cycles > g_lines.max_cycles) {
+		g_lines.max_cycles = g_lines.cycles;
+	}
+
+	/* Write the header in front of the line segments */
+	lines->end = xTaskGetTickCount();
+	dataEncode(DP_AZIMUTH_SCAN, (lines->profile << 8) | lines->scan_id, lines->data);
+	dataEncodeValue(lines->points, 2, &lines->data[4]);
+	lines->data[lines->length] = '\0';
+
+	/* Send the line segments directly from their buffer */
+	lines->busy = 1;
+	message.type = MSG_TYPE_LINES;
+	message.msg = lines->data;
+	message.length = lines->length;
+	message.busy = &lines->busy;
+	if (xQueueSend(queueMessageBlock, &message, 0) != pdTRUE) {
+		lines->busy = 0;
+		g_lines.overruns++;
+	}
+	g_lines.latest = lines;
+}
+
+/**
+ * \brief	Gets the statistics of the line segment extraction.
+ * \param[out]	lines is the number of line segments of the latest scan.
+ * \param[out]	scan_us is the maximum extraction time of a scan. [us]
+ * \param[out]	overruns is the number of scans without line segments.
+ */
+void taskDataProcessingLineStats(uint32_t *lines, uint32_t *scan_us, uint32_t *overruns) {
+	*lines = g_lines.latest ? g_lines.latest->points : 0;
+	*scan_us = (uint64_t) g_lines.max_cycles * 1000000ULL / SystemCoreClock;
+	*overruns = g_lines.overruns;
+}
+
+/**
+ * \brief	Checks the point against the protective zones. An alarm is raised
+ * 			after DP_ZONE_HITS consecutive points within a zone.
+ * \param[in]	azimuth is the azimuth of the point. [tenth degree]
+ * \param[in]	distance is the corrected distance of the point. [mm]
+ * \param[in]	cycles is the cycle counter at the end of the measurement.
+ */
+void zonesCheck(int16_t azimuth, int16_t distance, uint32_t cycles) {
+	uint32_t i;
+	zone_t *zone;
+
+	for (i=0; i<DP_ZONE_MAX; i++) {
+		zone = &g_zones.zone[i];
+		if (zone->distance == 0 || azimuth < zone->left || azimuth > zone->right) {
+			continue;
+		}
+
+		/* Points without an echo are not within the zone */
+		if (distance >= 0 && distance < zone->distance) {
+			if (g_zones.hits[i] < DP_ZONE_HITS) {
+				g_zones.hits[i]++;
+			}
+		}
+		else {
+			g_zones.hits[i] = 0;
+		}
+
+		if (g_zones.hits[i] >= DP_ZONE_HITS) {
+			g_zones.intruded |= 1 << i;
+
+			/* Raise the alarm */
+			if (!(g_zones.alarm & (1 << i))) {
+				bsp_LedSetOn(DP_ZONE_ALARM_LED);
+				cycles = DWT->CYCCNT - cycles;
+				if (cycles > g_zones.latency) {
+					g_zones.latency = cycles;
+				}
+				g_zones.alarm |= 1 << i;
+				g_zones.events++;
+				zoneAlarm(i, 1, (uint64_t) cycles * 1000000ULL / SystemCoreClock);
+			}
+		}
+	}
+}
+
+/**
+ * \brief	Clears the alarms of the zones without an intrusion in the last
+ * 			scan. Called at the start of each scan.
+ */
+void zonesScan(void) {
+	uint32_t i;
+
+	for (i=0; i<DP_ZONE_MAX; i++) {
+		if ((g_zones.alarm & (1 << i)) && !(g_zones.intruded & (1 << i))) {
+			g_zones.alarm &= ~(1 << i);
+			zoneAlarm(i, 0, 0);
+		}
+		g_zones.hits[i] = 0;
+	}
+	g_zones.intruded = 0;
+
+	if (g_zones.alarm == 0) {
+		bsp_LedSetOff(DP_ZONE_ALARM_LED);
+	}
+}
+
+/**
+ * \brief	Sends a state message of a zone alarm to the gatekeeper task. It
+ * 			overtakes the data stream.
+ * \param[in]	index is the number of the zone.
+ * \param[in]	alarm is TRUE if the alarm is raised, FALSE if it is cleared.
+ * \param[in]	latency_us is the time from the end of the measurement to the alarm. [us]
+ */
+void zoneAlarm(uint8_t index, uint8_t alarm, uint32_t latency_us) {
+	message_t message;
+
+	message.type = MSG_TYPE_STATE;
+	if (alarm) {
+		sprintf(message.msg, "zone %u on %u", (unsigned int) index, (unsigned int) latency_us);
+	}
+	else {
+		sprintf(message.msg, "zone %u off", (unsigned int) index);
+	}
+
+	/* Only a queued alarm wakes up the gatekeeper */
+	if (xQueueSend(queueMessageAlarm, &message, 0) == pdTRUE) {
+		xSemaphoreGive(semaphoreMessageAlarm);
+	}
+	else {
+		g_zones.dropped++;
+	}
+}
+
+/**
+ * \brief	Gets the statistics of the protective zones.
+ * \param[out]	events is the number of raised alarms.
+ * \param[out]	latency_us is the worst time from the end of the measurement to the alarm. [us]
+ * \param[out]	dropped is the number of alarm messages lost by a full queue.
+ */
+void taskDataProcessingZoneStats(uint32_t *events, uint32_t *latency_us, uint32_t *dropped) {
+	*events = g_zones.events;
+	*dropped = g_zones.dropped;
+	*latency_us = (uint64_t) g_zones.latency * 1000000ULL / SystemCoreClock;
+}
+
+/**
+ * \brief	Learns the background with the point, or checks if it is in the
+ * 			foreground. The foreground points are clustered in the blob mode.
+ * \param[in]	point is the processed point.
+ * \return	TRUE if the point is sent.
+ */
+uint8_t backgroundPoint(const point_t *point) {
+	uint32_t bin = point->increments / DP_BACKGROUND_BIN_INC;
+	uint8_t valid = (point->distance != DP_DISTANCE_REJECTED && point->distance < 0xFFF);
+	uint8_t foreground;
+	int32_t distance = point->distance;
+
+	if (g_background.learning) {
+		/* Range of the distances of the bin, from the first complete turn */
+		if (g_background.started && valid) {
+			if (g_background.near[bin] == DP_BACKGROUND_EMPTY || distance < g_background.near[bin]) {
+				g_background.near[bin] = distance;
+			}
+			if (distance > g_background.far[bin]) {
+				g_background.far[bin] = distance;
+			}
+		}
+		return 0;
+	}
+
+	foreground = backgroundForeground(point);
+
+	if (g_background.mode == DP_BACKGROUND_BLOBS) {
+		if (foreground) {
+			blobAdd(point);
+		}
+		else {
+			blobSend();
+		}
+		return 0;
+	}
+
+	return foreground;
+}
+
+/**
+ * \brief	Checks if the point is in the foreground. Without the background
+ * 			change detection, each point with a distance is in the foreground.
+ * \param[in]	point is the processed point.
+ * \return	TRUE if the point is in the foreground, FALSE while learning.
+ */
+uint8_t backgroundForeground(const point_t *point) {
+	uint32_t bin = point->increments / DP_BACKGROUND_BIN_INC;
+	int32_t distance = point->distance;
+
+	if (point->distance == DP_DISTANCE_REJECTED || point->distance >= 0xFFF) {
+		return 0;
+	}
+	if (g_background.mode == DP_BACKGROUND_OFF) {
+		return 1;
+	}
+	if (g_background.learning) {
+		return 0;
+	}
+
+	/* A bin without a background echo has no range */
+	return g_background.near[bin] == DP_BACKGROUND_EMPTY
+			|| distance + g_background.tolerance < g_background.near[bin]
+			|| distance > g_background.far[bin] + g_background.tolerance;
+}
+
+/**
+ * \brief	Completes the last blob of the turn and counts the turns to learn
+ * 			the background. Called at the start of each scan.
+ */
+void backgroundScan(void) {
+	message_t message;
+
+	blobSend();
+
+	if (!g_background.learning) {
+		return;
+	}
+
+	if (!g_background.started) {
+		/* The first complete turn starts now */
+		g_background.started = 1;
+	}
+	else if (--g_background.turns == 0) {
+		g_background.learning = 0;
+
+		/* Tell the user the background is learned */
+		message.type = MSG_TYPE_STATE;
+		strcpy(message.msg, "background learned");
+		xQueueSend(queueMessage, &message, portMAX_DELAY);
+	}
+}
+
+/**
+ * \brief	Adds a foreground point to the blob. A gap of the azimuth or a step
+ * 			of the distance completes the blob, and a new one starts.
+ * \param[in]	point is the foreground point.
+ */
+void blobAdd(const point_t *point) {
+	if (g_background.blob.points > 0
+			&& (point->increments - g_background.blob.increments > DP_SPATIAL_GAP_INC
+					|| abs(point->distance - g_background.blob.distance) > DP_BLOB_GAP)) {
+		blobSend();
+	}
+
+	if (g_background.blob.points == 0) {
+		g_background.blob.left = point->azimuth;
+		g_background.blob.nearest = point->distance;
+	}
+	g_background.blob.right = point->azimuth;
+	g_background.blob.increments = point->increments;
+	g_background.blob.distance = point->distance;
+	if (point->distance < g_background.blob.nearest) {
+		g_background.blob.nearest = point->distance;
+	}
+	g_background.blob.points++;
+}
+
+/**
+ * \brief	Sends the blob to the gatekeeper task, if it has enough points.
+ */
+void blobSend(void) {
+	message_t message;
+
+	if (g_background.blob.points >= DP_BLOB_POINTS) {
+		message.type = MSG_TYPE_BLOB;
+		dataEncode(g_background.blob.left, g_background.blob.right, message.msg);
+		dataEncode(g_background.blob.nearest, (g_background.blob.points > 0xFFF) ? 0xFFF : g_background.blob.points,
+				&message.msg[4]);
+		message.msg[DP_BLOB_LENGTH] = '\0';
+		xQueueSend(queueMessage, &message, portMAX_DELAY);
+	}
+	g_background.blob.points = 0;
+}
+
+/**
+ * \brief	Gets the statistics of the output of the points.
+ * \param[out]	suppressed is the ratio of the points suppressed by the background. [per mill]
+ * \param[out]	point_ns is the mean output time each point. [ns]
+ */
+void taskDataProcessingOutputStats(uint32_t *suppressed, uint32_t *point_ns) {
+	*suppressed = g_output.points ? (uint64_t) g_output.suppressed * 1000 / g_output.points : 0;
+	*point_ns = g_output.points ? (uint64_t) g_output.cycles * 1000000000ULL / SystemCoreClock / g_output.points : 0;
+}
+
+/**
+ * \brief	Sends a marker for each point, which the data acquisition lost by a
+ * 			fault before the given position. It is called before a point or
+ * 			the scan start marker is sent, so the markers keep the order of
+ * 			the points. The faults of later points stay in the queue. The
+ * 			frames, the line segments and the burst capture have no markers,
+ * 			their faults are only removed.
+ * \param[in]	scan_id is the turn of the next point.
+ * \param[in]	increments is the azimuth of the next point, 0 for the start of
+ * 				the turn.
+ */
+void faultMarkers(uint8_t scan_id, uint32_t increments) {
+	char marker[DATA_MESSAGE_STRING_LENGTH];
+	rawdatafault_t fault;
+
+	while (xQueuePeek(queueRawDataFault, &fault, 0) == pdTRUE) {
+		/* The lost point must be in an earlier turn or before the azimuth */
+		if ((int8_t) (scan_id - fault.scan_id) < 0
+				|| (fault.scan_id == scan_id && fault.increments >= increments)) {
+			break;
+		}
+		xQueueReceive(queueRawDataFault, &fault, 0);
+
+		if (!g_capture.active && !g_frame.enable && g_lines.mode != DP_LINES_ONLY) {
+			dataEncode(DP_AZIMUTH_FAULT, increments2tenthdegree(fault.increments), marker);
+			marker[4] = '\0';
+			xQueueSend(queueMessageData, marker, g_qos.enable ? 0 : portMAX_DELAY);
+		}
+	}
+}
+
+/**
+ * \brief	Updates the level of the governor. The pressure is the occupancy of
+ * 			the raw data pool or the backlog of the serial link, the data queue
+ * 			and the TX circular buffer together. A high pressure raises the
+ * 			level each DP_QOS_RAISE_MS, a low pressure over DP_QOS_LOWER_MS
+ * 			lowers it. A pause of the data acquisition resets it.
+ */
+void qosUpdate(void) {
+	TickType_t now = xTaskGetTickCount();
+	uint32_t pool, link;
+	uint8_t level = g_qos.level;
+
+	/* Occupancy of the raw data pool */
+	pool = (u32MemGetNumberOfBlocks(&memRawData) - u32MemGetNumberOfFreeBlocks(&memRawData)) * 100
+			/ u32MemGetNumberOfBlocks(&memRawData);
+
+	/* Characters waiting for the serial interface */
+	link = (uxQueueMessagesWaiting(queueMessageData) * DATA_MESSAGE_STRING_LENGTH
+			+ (TX_BUFFER_LEN - 2) - bsp_SerialTxFree()) * 100
+			/ (Q_MESSAGE_DATA_LENGTH * DATA_MESSAGE_STRING_LENGTH + TX_BUFFER_LEN - 2);
+
+	g_qos.pressure = (pool > link) ? pool : link;
+	if (g_qos.pressure > DP_QOS_LOW) {
+		g_qos.high = now;
+	}
+
+	if (now - g_qos.updated > DP_QOS_LOWER_MS / portTICK_PERIOD_MS) {
+		/* The data acquisition was paused */
+		level = 0;
+		g_qos.changed = now;
+	}
+	else if (g_qos.pressure >= DP_QOS_HIGH && level < DP_QOS_SKIP
+			&& now - g_qos.changed >= DP_QOS_RAISE_MS / portTICK_PERIOD_MS) {
+		level++;
+		g_qos.changed = now;
+	}
+	else if (level > 0 && now - g_qos.high >= DP_QOS_LOWER_MS / portTICK_PERIOD_MS
+			&& now - g_qos.changed >= DP_QOS_LOWER_MS / portTICK_PERIOD_MS) {
+		level--;
+		g_qos.changed = now;
+	}
+	g_qos.updated = now;
+
+	/* The acquisition reduces the laser pulses and skips the bins */
+	if (level != g_qos.level) {
+		g_qos.level = level;
+		taskDataAcquisitionSetQos(level);
+	}
+}
+
+/**
+ * \brief	Gets the state and the drops of the governor.
+ * \param[out]	level is the current level, 0 for the full data stream.
+ * \param[out]	pressure is the latest pressure. [percent]
+ * \param[out]	decimated is the number of decimated points.
+ * \param[out]	dropped is the number of points dropped by a full data queue.
+ */
+void taskDataProcessingQosStats(uint8_t *level, uint8_t *pressure, uint32_t *decimated, uint32_t *dropped) {
+	*level = g_qos.level;
+	*pressure = g_qos.pressure;
+	*decimated = g_qos.decimated;
+	*dropped = g_qos.dropped;
+}
+
+/**
+ * \brief	Adds a point to the cluster of the object tracker. A point in the
+ * 			background, a gap of the azimuth or a step of the distance
+ * 			completes the cluster, and a new one starts.
+ * \param[in]	point is the processed point.
+ */
+void trackerPoint(const point_t *point) {
+	uint32_t cycles = DWT->CYCCNT;
+	int32_t x, y;
+
+	if (!backgroundForeground(point)) {
+		trackerCluster();
+	}
+	else {
+		if (g_tracker.cluster.points > 0
+				&& (point->increments - g_tracker.cluster.increments > DP_SPATIAL_GAP_INC
+						|| abs(point->distance - g_tracker.cluster.distance) > DP_BLOB_GAP)) {
+			trackerCluster();
+		}
+
+		cartesianPoint(point, &x, &y);
+		if (g_tracker.cluster.points == 0) {
+			g_tracker.cluster.sx = 0;
+			g_tracker.cluster.sy = 0;
+			g_tracker.cluster.min_x = x;
+			g_tracker.cluster.max_x = x;
+			g_tracker.cluster.min_y = y;
+			g_tracker.cluster.max_y = y;
+		}
+		g_tracker.cluster.increments = point->increments;
+		g_tracker.cluster.distance = point->distance;
+		g_tracker.cluster.sx += x;
+		g_tracker.cluster.sy += y;
+		if (x < g_tracker.cluster.min_x) g_tracker.cluster.min_x = x;
+		if (x > g_tracker.cluster.max_x) g_tracker.cluster.max_x = x;
+		if (y < g_tracker.cluster.min_y) g_tracker.cluster.min_y = y;
+		if (y > g_tracker.cluster.max_y) g_tracker.cluster.max_y = y;
+		g_tracker.cluster.points++;
+	}
+
+	g_tracker.cycles += DWT->CYCCNT - cycles;
+}
+
+/**
+ * \brief	Completes the cluster into an object of the current scan, if it
+ * 			has enough points. It is dropped if all objects are used.
+ */
+void trackerCluster(void) {
+	uint32_t width, depth;
+
+	if (g_tracker.cluster.points >= DP_BLOB_POINTS) {
+		if (g_tracker.objects < DP_CLUSTER_MAX) {
+			width = g_tracker.cluster.max_x - g_tracker.cluster.min_x;
+			depth = g_tracker.cluster.max_y - g_tracker.cluster.min_y;
+			g_tracker.object[g_tracker.objects].x = (float) g_tracker.cluster.sx / g_tracker.cluster.points;
+			g_tracker.object[g_tracker.objects].y = (float) g_tracker.cluster.sy / g_tracker.cluster.points;
+			g_tracker.object[g_tracker.objects].extent = (width > depth) ? width : depth;
+			g_tracker.objects++;
+		}
+		else {
+			g_tracker.dropped++;
+		}
+	}
+	g_tracker.cluster.points = 0;
+}
+
+/**
+ * \brief	Tracks the objects of the last scan and sends the tracks. Called
+ * 			at the start of each scan. Each track is predicted to the scan
+ * 			start, then each object is associated with the nearest predicted
+ * 			track within the gate, or it starts a new track. The worst case
+ * 			is DP_CLUSTER_MAX times DP_TRACK_MAX distances.
+ * \param[in]	scan_id is the number of the new turn.
+ * \param[in]	profile is the scan profile of the new turn.
+ */
+void trackerScan(uint8_t scan_id, uint8_t profile) {
+	uint32_t cycles = DWT->CYCCNT;
+	TickType_t tick = xTaskGetTickCount();
+	float dt, dx, dy, d2, best_d2;
+	uint32_t i, j, best;
+
+	/* The last object of the turn */
+	trackerCluster();
+
+	/* Time since the last scan start [s], the tracks are lost after a pause */
+	dt = (float) (tick - g_tracker.tick) / configTICK_RATE_HZ;
+	if (tick - g_tracker.tick > DP_TRACK_PAUSE_MS / portTICK_PERIOD_MS) {
+		for (i=0; i<DP_TRACK_MAX; i++) {
+			g_tracker.track[i].id = 0;
+		}
+	}
+	if (dt <= 0.0f) {
+		dt = 1.0f / configTICK_RATE_HZ;
+	}
+	g_tracker.tick = tick;
+
+	/* Predict the tracks with their velocity */
+	for (i=0; i<DP_TRACK_MAX; i++) {
+		g_tracker.track[i].x += g_tracker.track[i].vx * dt;
+		g_tracker.track[i].y += g_tracker.track[i].vy * dt;
+		g_tracker.track[i].updated = 0;
+	}
+
+	for (j=0; j<g_tracker.objects; j++) {
+		/* Nearest predicted track within the gate */
+		best = DP_TRACK_MAX;
+		best_d2 = (float) g_tracker.gate * g_tracker.gate;
+		for (i=0; i<DP_TRACK_MAX; i++) {
+			if (g_tracker.track[i].id == 0 || g_tracker.track[i].updated) {
+				continue;
+			}
+			dx = g_tracker.object[j].x - g_tracker.track[i].x;
+			dy = g_tracker.object[j].y - g_tracker.track[i].y;
+			d2 = dx * dx + dy * dy;
+			if (d2 <= best_d2) {
+				best_d2 = d2;
+				best = i;
+			}
+		}
+
+		if (best < DP_TRACK_MAX) {
+			/* Constant velocity filter with the residual of the position */
+			dx = g_tracker.object[j].x - g_tracker.track[best].x;
+			dy = g_tracker.object[j].y - g_tracker.track[best].y;
+			g_tracker.track[best].x += DP_TRACK_ALPHA * dx;
+			g_tracker.track[best].y += DP_TRACK_ALPHA * dy;
+			g_tracker.track[best].vx += DP_TRACK_BETA * dx / dt;
+			g_tracker.track[best].vy += DP_TRACK_BETA * dy / dt;
+			if (g_tracker.track[best].hits < DP_TRACK_CONFIRM) {
+				g_tracker.track[best].hits++;
+			}
+		}
+		else {
+			/* New track in a free place of the arena */
+			for (best=0; best<DP_TRACK_MAX && g_tracker.track[best].id != 0; best++);
+			if (best == DP_TRACK_MAX) {
+				g_tracker.dropped++;
+				continue;
+			}
+			g_tracker.track[best].id = g_tracker.next_id;
+			g_tracker.next_id = (g_tracker.next_id >= DP_TRACK_ID_MAX) ? 1 : g_tracker.next_id + 1;
+			g_tracker.track[best].x = g_tracker.object[j].x;
+			g_tracker.track[best].y = g_tracker.object[j].y;
+			g_tracker.track[best].vx = 0.0f;
+			g_tracker.track[best].vy = 0.0f;
+			g_tracker.track[best].hits = 1;
+		}
+		g_tracker.track[best].extent = g_tracker.object[j].extent;
+		g_tracker.track[best].missed = 0;
+		g_tracker.track[best].updated = 1;
+	}
+	g_tracker.objects = 0;
+
+	/* A track without an object is predicted, until it has too many misses */
+	for (i=0; i<DP_TRACK_MAX; i++) {
+		if (g_tracker.track[i].id != 0 && !g_tracker.track[i].updated
+				&& ++g_tracker.track[i].missed > g_tracker.misses) {
+			g_tracker.track[i].id = 0;
+		}
+	}
+
+	trackerSend();
+	g_tracker.scan_id = scan_id;
+	g_tracker.profile = profile;
+
+	g_tracker.cycles += DWT->CYCCNT - cycles;
+	if (g_tracker.cycles > g_tracker.max_cycles) {
+		g_tracker.max_cycles = g_tracker.cycles;
+	}
+	g_tracker.cycles = 0;
+}
+
+/**
+ * \brief	Encodes the confirmed tracks of the last scan and sends them to the
+ * 			gatekeeper task as one message. They are dropped if the gatekeeper
+ * 			still sends the buffer.
+ */
+void trackerSend(void) {
+	frame_t *objects;
+	messageblock_t message;
+	char *ptr;
+	uint32_t i;
+	int32_t extent;
+
+	/* Take the other buffer than the latest objects */
+	objects = (g_tracker.latest == &g_tracker.buffer[0]) ? &g_tracker.buffer[1] : &g_tracker.buffer[0];
+	if (objects->busy) {
+		/* The serial interface is too slow for the objects */
+		g_tracker.overruns++;
+		return;
+	}
+
+	objects->scan_id = g_tracker.scan_id;
+	objects->profile = g_tracker.profile;
+	objects->points = 0;
+	objects->end = xTaskGetTickCount();
+	objects->start = objects->end;
+	objects->length = DP_OBJECTS_HEADER_LENGTH;
+
+	for (i=0; i<DP_TRACK_MAX; i++) {
+		if (g_tracker.track[i].id == 0 || g_tracker.track[i].hits < DP_TRACK_CONFIRM) {
+			continue;
+		}
+		extent = g_tracker.track[i].extent;
+		ptr = &objects->data[objects->length];
+		dataEncodeValue(g_tracker.track[i].id, 2, &ptr[0]);
+		dataEncodeValue(lroundf(g_tracker.track[i].x), DP_CARTESIAN_DIGITS, &ptr[2]);
+		dataEncodeValue(lroundf(g_tracker.track[i].y), DP_CARTESIAN_DIGITS, &ptr[5]);
+		dataEncodeValue(lroundf(g_tracker.track[i].vx), DP_CARTESIAN_DIGITS, &ptr[8]);
+		dataEncodeValue(lroundf(g_tracker.track[i].vy), DP_CARTESIAN_DIGITS, &ptr[11]);
+		dataEncodeValue((extent > 0xFFF) ? 0xFFF : extent, 2, &ptr[14]);
+		objects->length += DP_OBJECT_LENGTH;
+		objects->points++;
+	}
+
+	/* Write the header in front of the objects */
+	dataEncode(DP_AZIMUTH_SCAN, (objects->profile << 8) | objects->scan_id, objects->data);
+	dataEncodeValue(objects->points, 2, &objects->data[4]);
+	objects->data[objects->length] = '\0';
+
+	/* Send the objects directly from their buffer */
+	objects->busy = 1;
+	message.type = MSG_TYPE_OBJECTS;
+	message.msg = objects->data;
+	message.length = objects->length;
+	message.busy = &objects->busy;
+	if (xQueueSend(queueMessageBlock, &message, 0) != pdTRUE) {
+		objects->busy = 0;
+		g_tracker.overruns++;
+	}
+	g_tracker.latest = objects;
+}
+
+/**
+ * \brief	Gets the statistics of the object tracker.
+ * \param[out]	objects is the number of sent objects of the latest scan.
+ * \param[out]	scan_us is the maximum tracking time of a scan, with the clustering of its points. [us]
+ * \param[out]	dropped is the number of objects without a free cluster or track.
+ * \param[out]	overruns is the number of scans without sent objects.
+ */
+void taskDataProcessingTrackerStats(uint32_t *objects, uint32_t *scan_us, uint32_t *dropped, uint32_t *overruns) {
+	*objects = g_tracker.latest ? g_tracker.latest->points : 0;
+	*scan_us = (uint64_t) g_tracker.max_cycles * 1000000ULL / SystemCoreClock;
+	*dropped = g_tracker.dropped;
+	*overruns = g_tracker.overruns;
+}
+
+/**
+ * \brief	Encodes the raw TDC data of a point and sends it to the gatekeeper
+ * 			task. The record contains, with the digits of each value:
+ * 			sequence (2), increments (2), profile and scan number (2), pulse
+ * 			width and calibration flag (2), expected hits (1), hits (1),
+ * 			resonator calibration (6), temperature (6), cycle counter (6),
+ * 			each hit (6) and the CRC16 of the record (3).
+ * \param[in]	raw_data is the raw data of the point.
+ */
+void rawDump(const rawdata_t *raw_data) {
+	char *ptr = g_raw.data[g_raw.next];
+	messageblock_t message;
+	uint32_t i, length;
+
+	if (g_raw.busy[g_raw.next]) {
+		/* The serial interface is too slow for the raw data */
+		g_raw.dropped++;
+		g_raw.sequence++;
+		return;
+	}
+
+	dataEncodeValue(g_raw.sequence, 2, &ptr[0]);
+	dataEncodeValue(raw_data->increments, 2, &ptr[2]);
+	dataEncodeValue((raw_data->profile << 8) | raw_data->scan_id, 2, &ptr[4]);
+	dataEncodeValue((raw_data->calibrate ? 0x100 : 0) | raw_data->pulse_width, 2, &ptr[6]);
+	dataEncodeValue(raw_data->expected_points, 1, &ptr[8]);
+	dataEncodeValue(raw_data->raw_ctr, 1, &ptr[9]);
+	dataEncodeValue(raw_data->cal_resonator, 6, &ptr[10]);
+	dataEncodeValue(raw_data->temperature, 6, &ptr[16]);
+	dataEncodeValue(raw_data->cycles, 6, &ptr[22]);
+	length = DP_RAW_HEADER_LENGTH;
+	for (i=0; i<raw_data->raw_ctr && i<MAX_RAWDATA_LENGTH; i++) {
+		dataEncodeValue(raw_data->raw[i], DP_RAW_HIT_DIGITS, &ptr[length]);
+		length += DP_RAW_HIT_DIGITS;
+	}
+	dataEncodeValue(dataCrc16(ptr, length), DP_CAPTURE_CRC_DIGITS, &ptr[length]);
+	length += DP_CAPTURE_CRC_DIGITS;
+	ptr[length] = '\0';
+
+	/* Send the record directly from its buffer */
+	g_raw.busy[g_raw.next] = 1;
+	message.type = MSG_TYPE_RAW;
+	message.msg = ptr;
+	message.length = length;
+	message.busy = &g_raw.busy[g_raw.next];
+	if (xQueueSend(queueMessageBlock, &message, 0) != pdTRUE) {
+		g_raw.busy[g_raw.next] = 0;
+		g_raw.dropped++;
+	}
+	else {
+		g_raw.records++;
+		g_raw.next = (g_raw.next + 1) % DP_RAW_BUFFERS;
+	}
+	g_raw.sequence++;
+}
+
+/**
+ * \brief	Gets the statistics of the raw dump.
+ * \param[out]	records is the number of sent records.
+ * \param[out]	dropped is the number of dropped records.
+ */
+void taskDataProcessingRawStats(uint32_t *records, uint32_t *dropped) {
+	*records = g_raw.records;
+	*dropped = g_raw.dropped;
+}
+
+/**
+ * \brief	Appends a point to the captured frame of the current scan. A point
+ * 			without a place in the storage marks the scan as incomplete.
+ * \param[in]	point is the processed point.
+ */
+void capturePoint(const point_t *point) {
+	frame_t *frame = &g_capture.frame;
+
+	/* The capture starts with the next scan, or the scan does not fit */
+	if (frame->data == NULL || g_capture.full || g_capture.scans == 0) {
+		return;
+	}
+
+	/* A point without a distance has no Cartesian coordinates */
+	if (g_cartesian.enable && (point->distance == DP_DISTANCE_REJECTED || point->distance >= 0xFFF)) {
+		return;
+	}
+
+	if (g_capture.length + frame->length + DATA_MESSAGE_STRING_LENGTH + DP_CAPTURE_CRC_DIGITS + 1 > DP_CAPTURE_LENGTH) {
+		g_capture.full = 1;
+		return;
+	}
+	frame->length += encodePoint(point, &frame->data[frame->length]);
+	frame->points++;
+}
+
+/**
+ * \brief	Completes the captured frame of the last scan with its header and
+ * 			CRC, and starts the frame of the new scan behind it. The controller
+ * 			is told the end of the capture, after the last scan or if the
+ * 			storage is full. An incomplete scan is dropped.
+ * \param[in]	scan_id is the number of the new turn.
+ * \param[in]	profile is the scan profile of the new turn.
+ */
+void captureScan(uint8_t scan_id, uint8_t profile) {
+	frame_t *frame = &g_capture.frame;
+	event_t event;
+
+	if (frame->data != NULL && !g_capture.full && g_capture.scans > 0) {
+		/* Write the header in front of the points and the CRC behind them */
+		frame->end = xTaskGetTickCount();
+		dataEncode(g_cartesian.enable ? DP_AZIMUTH_CARTESIAN : DP_AZIMUTH_SCAN,
+				(frame->profile << 8) | frame->scan_id, frame->data);
+		dataEncodeValue(frame->points, DP_FRAME_POINTS_DIGITS, &frame->data[4]);
+		dataEncodeValue(frame->start, DP_FRAME_TICK_DIGITS, &frame->data[4 + DP_FRAME_POINTS_DIGITS]);
+		dataEncodeValue(frame->end, DP_FRAME_TICK_DIGITS, &frame->data[4 + DP_FRAME_POINTS_DIGITS + DP_FRAME_TICK_DIGITS]);
+		dataEncodeValue(dataCrc16(frame->data, frame->length), DP_CAPTURE_CRC_DIGITS, &frame->data[frame->length]);
+		frame->length += DP_CAPTURE_CRC_DIGITS;
+		frame->data[frame->length] = '\0';
+
+		g_capture.offset[g_capture.frames] = g_capture.length;
+		g_capture.frames++;
+		g_capture.length += frame->length + 1;
+		g_capture.scans--;
+	}
+
+	/* The next frame needs at least its header and CRC */
+	if (g_capture.length + DP_FRAME_HEADER_LENGTH + DP_CAPTURE_CRC_DIGITS + 1 > DP_CAPTURE_LENGTH) {
+		g_capture.full = 1;
+	}
+
+	if (g_capture.full || g_capture.frames >= DP_CAPTURE_SCANS_MAX) {
+		g_capture.scans = 0;
+	}
+
+	if (g_capture.scans == 0) {
+		/* Tell the controller the end, again at the next scan if its queue is full */
+		frame->data = NULL;
+		event.event = Sys_CaptureDone;
+		event.param.capture = g_capture.frames;
+		if (xQueueSend(queueEvent, &event, 0) == pdTRUE) {
+			g_capture.active = 0;
+		}
+		return;
+	}
+
+	/* The frame of the new scan, the header is written when the scan is complete */
+	frame->scan_id = scan_id;
+	frame->profile = profile;
+	frame->points = 0;
+	frame->start = xTaskGetTickCount();
+	frame->end = frame->start;
+	frame->length = DP_FRAME_HEADER_LENGTH;
+	frame->data = &g_captureStorage[g_capture.length];
+}
+
+/**
+ * \brief	Gets the complete frames of the burst capture.
+ * \param[out]	bytes is the used storage. [bytes]
+ * \return	Number of complete frames.
+ */
+uint32_t taskDataProcessingCaptureFrames(uint32_t *bytes) {
+	*bytes = g_capture.length;
+	return g_capture.frames;
+}
+
+/**
+ * \brief	Gets a complete frame of the burst capture.
+ * \param[in]	index is the number of the frame, the first is 0.
+ * \param[out]	length is the number of characters, with the CRC.
+ * \return	Terminated frame, NULL if it does not exist.
+ */
+const char *taskDataProcessingCaptureFrame(uint32_t index, uint32_t *length) {
+	if (index >= g_capture.frames) {
+		*length = 0;
+		return NULL;
+	}
+	*length = strlen(&g_captureStorage[g_capture.offset[index]]);
+	return &g_captureStorage[g_capture.offset[index]];
+}
+
+/**
+ * \brief	Starts the frame of a new scan in the buffer, which is not used by
+ * 			the latest frame. The points of the scan are dropped if the
+ * 			gatekeeper still sends this buffer.
+ * \param[in]	scan_id is the number of the turn.
+ * \param[in]	profile is the scan profile of the turn.
+ */
+void frameStart(uint8_t scan_id, uint8_t profile) {
+	frame_t *frame;
+	uint32_t i;
+
+	/* Take the other buffer than the latest frame */
+	frame = (g_frame.latest == &g_frame.buffer[0]) ? &g_frame.buffer[1] : &g_frame.buffer[0];
+
+	if (frame->busy) {
+		/* The serial interface is too slow for the frames */
+		g_frame.current = NULL;
+		g_frame.drop = 1;
+		g_frame.overruns++;
+		return;
+	}
+
+	/* The header is written when the scan is complete */
+	frame->scan_id = scan_id;
+	frame->profile = profile;
+	frame->points = 0;
+	frame->start = xTaskGetTickCount();
+	frame->end = frame->start;
+	frame->length = DP_FRAME_HEADER_LENGTH;
+	g_frame.current = frame;
+	g_frame.drop = 0;
+
+	/* No bin has a point yet */
+	if (g_delta.keyframe) {
+		for (i=0; i<DP_DELTA_BINS; i++) {
+			g_delta.current[i] = DP_DELTA_EMPTY;
+		}
+	}
+}
+
+/**
+ * \brief	Completes the frame of the current scan with its header and sends
+ * 			it to the gatekeeper task as one message. A delta encoded frame is
+ * 			followed by its CRC.
+ */
+void frameComplete(void) {
+	frame_t *frame = g_frame.current;
+	messageblock_t message;
+
+	/* No frame was started for this scan */
+	if (frame == NULL) {
+		return;
+	}
+	g_frame.current = NULL;
+
+	/* Write the header in front of the points */
+	frame->end = xTaskGetTickCount();
+	if (g_delta.keyframe) {
+		frameDeltaEncode(frame);
+	}
+	else {
+		dataEncode(g_cartesian.enable ? DP_AZIMUTH_CARTESIAN : DP_AZIMUTH_SCAN,
+				(frame->profile << 8) | frame->scan_id, frame->data);
+	}
+	dataEncodeValue(frame->points, DP_FRAME_POINTS_DIGITS, &frame->data[4]);
+	dataEncodeValue(frame->start, DP_FRAME_TICK_DIGITS, &frame->data[4 + DP_FRAME_POINTS_DIGITS]);
+	dataEncodeValue(frame->end, DP_FRAME_TICK_DIGITS, &frame->data[4 + DP_FRAME_POINTS_DIGITS + DP_FRAME_TICK_DIGITS]);
+	if (g_delta.keyframe) {
+		/* The receiver detects a corrupted delta frame and waits for the next keyframe */
+		dataEncodeValue(dataCrc16(frame->data, frame->length), DP_DELTA_CRC_DIGITS, &frame->data[frame->length]);
+		frame->length += DP_DELTA_CRC_DIGITS;
+	}
+	frame->data[frame->length] = '\0';
+
+	/* Send the frame directly from its buffer */
+	frame->busy = 1;
+	message.type = MSG_TYPE_FRAME;
+	message.msg = frame->data;
+	message.length = frame->length;
+	message.busy = &frame->busy;
+	if (xQueueSend(queueMessageBlock, &message, 0) != pdTRUE) {
+		frame->busy = 0;
+		g_frame.overruns++;
+
+		/* The receiver missed the changed bins */
+		g_delta.force = 1;
+	}
+	g_frame.latest = frame;
+}
+
+/**
+ * \brief	Encodes the bins of the current scan as a delta frame. The points
+ * 			are a bitmap of the sent bins, followed by the distance difference
+ * 			of each sent bin to its reference. A keyframe clears the reference,
+ * 			so it contains all bins with a point.
+ * \param[in,out]	frame is the frame of the current scan, with an empty body.
+ */
+void frameDeltaEncode(frame_t *frame) {
+	uint32_t i;
+	uint8_t bitmap = 0;
+	uint8_t key;
+	int16_t reference;
+
+	/* Periodic keyframe, or after a lost frame */
+	key = (g_delta.count == 0 || g_delta.force);
+	if (key) {
+		for (i=0; i<DP_DELTA_BINS; i++) {
+			g_delta.reference[i] = DP_DELTA_EMPTY;
+		}
+		g_delta.count = 0;
+		g_delta.force = 0;
+	}
+	if (++g_delta.count >= g_delta.keyframe) {
+		g_delta.count = 0;
+	}
+
+	/* Bitmap and the differences of the changed bins */
+	frame->length = DP_FRAME_HEADER_LENGTH + DP_DELTA_BITMAP_LENGTH;
+	for (i=0; i<DP_DELTA_BINS; i++) {
+		bitmap <<= 1;
+		reference = g_delta.reference[i];
+		if (g_delta.current[i] != DP_DELTA_EMPTY
+				&& (reference == DP_DELTA_EMPTY || abs(g_delta.current[i] - reference) > g_delta.threshold)
+				&& frame->length + DP_DELTA_VARINT_LENGTH + DP_DELTA_CRC_DIGITS <= DP_FRAME_LENGTH) {
+			bitmap |= 1;
+			if (reference == DP_DELTA_EMPTY) {
+				reference = 0;
+			}
+			frame->length += dataEncodeVarint(g_delta.current[i] - reference, &frame->data[frame->length]);
+			g_delta.reference[i] = g_delta.current[i];
+			frame->points++;
+		}
+
+		/* Six bins each character */
+		if (i % 6 == 5 || i == DP_DELTA_BINS - 1) {
+			bitmap <<= 5 - (i % 6);
+			dataEncodeValue(bitmap, 1, &frame->data[DP_FRAME_HEADER_LENGTH + i / 6]);
+			bitmap = 0;
+		}
+	}
+
+	/* Scan marker of the header */
+	dataEncode(key ? DP_AZIMUTH_KEYFRAME : DP_AZIMUTH_DELTA, (frame->profile << 8) | frame->scan_id, frame->data);
+}
+
+/**
+ * \brief	Latest complete frame of a scan. It is valid until the frame after
+ * 			the next one is started.
+ * \param[out]	overruns is the number of dropped frames.
+ * \return	The latest frame, or NULL if there is none.
+ */
+const frame_t *taskDataProcessingLatestFrame(uint32_t *overruns) {
+	*overruns = g_frame.overruns;
+	return g_frame.latest;
+}
+
 
 /**
  * @}
@@ -13,6 +13,7 @@
  */
 
 #include <stdint.h>
+#include <string.h>
 
 /* RTOS */
 #include "FreeRTOS.h"
@@ -57,6 +58,24 @@ QueueHandle_t queueMessage;
  */
 QueueHandle_t queueMessageData;
 
+/**
+ * \brief	Queue with the large messages, which are sent from the storage of
+ * 			the sender.
+ */
+QueueHandle_t queueMessageBlock;
+
+/**
+ * \brief	Queue with the alarm messages. They are sent before all other
+ * 			messages. It is not a member of the queue set, the sender gives
+ * 			semaphoreMessageAlarm after each alarm.
+ */
+QueueHandle_t queueMessageAlarm;
+
+/**
+ * \brief	Wakes up the gatekeeper task for the alarm messages.
+ */
+SemaphoreHandle_t semaphoreMessageAlarm;
+
 /**
  * \brief	Queue set to trigger a message.
  */
@@ -68,6 +87,19 @@ QueueSetHandle_t queueMessageSet;
 SemaphoreHandle_t mutexTxCircBuf;
 
 
+/*
+ * -----------------------------------------------------------------------
+ * Private variables
+ * -----------------------------------------------------------------------
+ */
+
+/**
+ * \brief	Number of data messages, which were dropped by a full TX circular
+ * 			buffer.
+ */
+static volatile uint32_t g_dataDropped;
+
+
 /*
  * ----------------------------------------------------------------------------
  * Implementation
@@ -90,11 +122,16 @@ void taskGatekeeperInit(void) {
 	/* Generate the queue */
 	queueMessage = xQueueCreate(Q_MESSAGE_LENGTH, sizeof(message_t));
 	queueMessageData = xQueueCreate(Q_MESSAGE_DATA_LENGTH, sizeof(char[DATA_MESSAGE_STRING_LENGTH]));
+	queueMessageBlock = xQueueCreate(Q_MESSAGE_BLOCK_LENGTH, sizeof(messageblock_t));
+	queueMessageAlarm = xQueueCreate(Q_MESSAGE_ALARM_LENGTH, sizeof(message_t));
+	semaphoreMessageAlarm = xSemaphoreCreateBinary();
 
 	/* Create the message queue set */
-	queueMessageSet = xQueueCreateSet(Q_MESSAGE_LENGTH + Q_MESSAGE_DATA_LENGTH);
+	queueMessageSet = xQueueCreateSet(Q_MESSAGE_LENGTH + Q_MESSAGE_DATA_LENGTH + Q_MESSAGE_BLOCK_LENGTH + 1);
 	xQueueAddToSet(queueMessage, queueMessageSet);
 	xQueueAddToSet(queueMessageData, queueMessageSet);
+	xQueueAddToSet(queueMessageBlock, queueMessageSet);
+	xQueueAddToSet(semaphoreMessageAlarm, queueMessageSet);
 
 	/* Generate the mutual exclusion */
 	mutexTxCircBuf = xSemaphoreCreateMutex();
@@ -108,8 +145,10 @@ void taskGatekeeperInit(void) {
  */
 void taskGatekeeper(void* pvParameters) {
 	QueueSetMemberHandle_t xActivatedMember;
+	QueueSetMemberHandle_t xSelectedMember = NULL;
 
 	message_t message;
+	messageblock_t message_block;
 	char message_data[DATA_MESSAGE_STRING_LENGTH + 1] = { '\0' };
 	char *ptr;
 
@@ -122,11 +161,33 @@ void taskGatekeeper(void* pvParameters) {
 
 	/* Loop forever */
 	for (;;) {
-		/* Get the message, which has to be sent */
-		xActivatedMember = xQueueSelectFromSet(queueMessageSet, portMAX_DELAY);
+		/* Wait for the next message, unless a selected message is still
+		 * pending or alarms are waiting */
+		if (xSelectedMember == NULL && uxQueueMessagesWaiting(queueMessageAlarm) == 0) {
+			xSelectedMember = xQueueSelectFromSet(queueMessageSet, portMAX_DELAY);
+			if (xSelectedMember == semaphoreMessageAlarm) {
+				/* It only wakes up the task, the alarms are polled below */
+				xSemaphoreTake(semaphoreMessageAlarm, 0);
+				xSelectedMember = NULL;
+			}
+		}
+
+		/* Check the type of the message. An alarm overtakes the selected
+		 * message, which is kept for the next loop */
+		if (xQueueReceive(queueMessageAlarm, &message, 0) == pdTRUE) {
+			xActivatedMember = queueMessageAlarm;
+			selector = message.type;
+			ptr = message.msg;
+		}
+		else {
+			xActivatedMember = xSelectedMember;
+			xSelectedMember = NULL;
+		}
 
-		/* Check the type of the message */
-		if (xActivatedMember == queueMessageData) {
+		if (xActivatedMember == queueMessageAlarm) {
+			/* An alarm message */
+		}
+		else if (xActivatedMember == queueMessageData) {
 			/* A data message */
 			xQueueReceive(queueMessageData, message_data, 0);
 			selector = MSG_TYPE_DATA;
@@ -138,18 +199,43 @@ void taskGatekeeper(void* pvParameters) {
 			selector = message.type;
 			ptr = message.msg;
 		}
+		else if (xActivatedMember == queueMessageBlock) {
+			/* A large message from the storage of the sender */
+			xQueueReceive(queueMessageBlock, &message_block, 0);
+			selector = message_block.type;
+			ptr = (char *) message_block.msg;
+		}
 		else {
 			/* Error event */
 			xActivatedMember = NULL;
 		}
 
 		if (xActivatedMember) {
-			/* Sets the timeout */
+			/* Sets the timeout, a large message needs more time on the serial interface */
 			timeout = 20;
+			if (xActivatedMember == queueMessageBlock) {
+				timeout += message_block.length / 100;
+			}
 
 			/* Takes the mutual exclusion to write into the circular buffer */
 			xSemaphoreTake(mutexTxCircBuf, portMAX_DELAY);
 
+			/* A data message is sent as a whole or dropped, a backed up serial
+			 * interface only thins out the data stream */
+			if (xActivatedMember == queueMessageData) {
+				timeout = DATA_MESSAGE_TIMEOUT;
+				while (bsp_SerialTxFree() < strlen(ptr) + sizeof(frame_end) && timeout > 0) {
+					/* No space available in the circular buffer */
+					vTaskDelay(10/portTICK_PERIOD_MS);
+					timeout--;
+				}
+				if (timeout == 0) {
+					g_dataDropped++;
+					xSemaphoreGive(mutexTxCircBuf);
+					continue;
+				}
+			}
+
 			/* Send the message type selector */
 			while (!bsp_SerialCharPut(selector) && timeout > 0) {
 				/* No space available in the circular buffer */
@@ -186,12 +272,25 @@ void taskGatekeeper(void* pvParameters) {
 
 			/* Release the mutual exclusion */
 			xSemaphoreGive(mutexTxCircBuf);
+
+			/* Release the storage of a large message */
+			if (xActivatedMember == queueMessageBlock) {
+				*message_block.busy = 0;
+			}
 		}
 	}
 
 	/* Never reach this point */
 }
 
+/**
+ * \brief	Gets the number of dropped data messages.
+ * \return	Data messages, which did not fit into the TX circular buffer in time.
+ */
+uint32_t taskGatekeeperDataDropped(void) {
+	return g_dataDropped;
+}
+
 
 /**
  * @}
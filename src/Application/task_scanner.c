@@ -28,12 +28,34 @@
 #include "bsp_engine.h"
 #include "bsp_quadenc.h"
 
+
+/*
+ * ----------------------------------------------------------------------------
+ * Private data types
+ * ----------------------------------------------------------------------------
+ */
+
+/**
+ * \brief	Iterative learning control of the speed ripple. It contains the
+ * 			feed-forward table and the measurement of the current turn.
+ */
+typedef struct {
+	int16_t feed_forward[ENGINE_ILC_BINS];	/*!< Learned feed-forward of each angle bin. [power] */
+	int32_t error_sum[ENGINE_ILC_BINS];		/*!< Sum of the speed error in the current turn. [increments/ms] */
+	int32_t speed_sum[ENGINE_ILC_BINS];		/*!< Sum of the speed in the current turn. [increments/ms] */
+	uint16_t samples[ENGINE_ILC_BINS];		/*!< Number of controller cycles in each bin of the current turn. */
+	uint8_t saturated;						/*!< TRUE if the controller was saturated in the current turn. */
+	uint8_t learned_turns;					/*!< Number of turns since the last reset of the table. */
+} ilc_t;
+
 /*
  * ----------------------------------------------------------------------------
  * Private functions prototypes
  * ----------------------------------------------------------------------------
  */
 void taskScanner(void* pvParameters);
+void ilcReset(ilc_t *ilc);
+uint16_t ilcTurnCompleted(ilc_t *ilc);
 
 
 /*
@@ -53,6 +75,34 @@ TaskHandle_t taskScannerHandle;
 QueueHandle_t queueSpeed;
 
 
+/*
+ * ----------------------------------------------------------------------------
+ * Private variables
+ * ----------------------------------------------------------------------------
+ */
+
+/**
+ * \brief	Speed ripple feed-forward learning.
+ */
+static ilc_t g_ilc;
+
+/**
+ * \brief	Enable or disable the speed ripple feed-forward.
+ */
+static volatile uint8_t g_ilcEnable = 1;
+
+/**
+ * \brief	Speed variation of the first turn after a set point change, before
+ * 			the feed-forward table was learned. [tenth percent]
+ */
+static volatile uint16_t g_rippleInitial;
+
+/**
+ * \brief	Speed variation of the last turn. [tenth percent]
+ */
+static volatile uint16_t g_rippleCurrent;
+
+
 /*
  * ----------------------------------------------------------------------------
  * Implementation
@@ -70,6 +120,9 @@ void taskScannerInit(void) {
 	/* Initialize the quadrature encoder */
 	bsp_QuadencInit();
 
+	/* Reset the speed ripple feed-forward */
+	ilcReset(&g_ilc);
+
 	/* Generate the task */
 	xTaskCreate(taskScanner, TASK_SCANNER_NAME, TASK_SCANNER_STACKSIZE,
 			NULL, TASK_SCANNER_PRIORITY, &taskScannerHandle);
@@ -98,6 +151,12 @@ void taskScanner(void* pvParameters) {
 	int32_t timeout;
 	event_t event;
 
+	uint32_t bin;
+	uint32_t last_bin = 0;
+	int32_t last_set_point = 0;
+	int32_t feed_forward;
+	uint16_t ripple;
+
 	/* Loop forever */
 	for (;;) {
 		/* Wait until the engine has to start */
@@ -140,15 +199,45 @@ void taskScanner(void* pvParameters) {
 			/* Calculate the difference */
 			e = set_point - process_variable;
 
+			/* A new set point invalidates the learned ripple */
+			if (set_point != last_set_point) {
+				ilcReset(&g_ilc);
+				last_set_point = set_point;
+			}
+
+			/* Angle bin of the current azimuth */
+			bin = current_azimuth * ENGINE_ILC_BINS / (BSP_QUADENC_INC_PER_TURN+1);
+			if (bin < last_bin && process_variable > 0) {
+				/* Turn completed -> learn the ripple of this turn */
+				ripple = ilcTurnCompleted(&g_ilc);
+				if (g_ilc.learned_turns == 1) {
+					g_rippleInitial = ripple;
+				}
+				g_rippleCurrent = ripple;
+			}
+			last_bin = bin;
+
+			/* Measure the speed of this angle bin */
+			g_ilc.error_sum[bin] += e;
+			g_ilc.speed_sum[bin] += process_variable;
+			g_ilc.samples[bin]++;
+
 			/* Integrator */
 			e_sum = e_sum + e;
 
 			/* PI controller */
 			controlling_element  = ENGINE_CONTROLER_KP * e + ENGINE_CONTROLER_KI * ENGINE_CONTROLER_TA * e_sum;
 
+			/* Feed-forward of the speed ripple, applied with a phase lead */
+			if (g_ilcEnable) {
+				feed_forward = g_ilc.feed_forward[(bin + ENGINE_ILC_LEAD) % ENGINE_ILC_BINS];
+				controlling_element += feed_forward;
+			}
+
 			/* Limit the controlling element */
 			if (controlling_element > ENGINE_MAX_POWER) {
 				controlling_element = ENGINE_MAX_POWER;
+				g_ilc.saturated = 1;
 				/* Anti windup */
 				e_sum = e_sum - e;
 				/* Check blocking engine */
@@ -160,6 +249,7 @@ void taskScanner(void* pvParameters) {
 			}
 			else if (controlling_element < (-1 * ENGINE_MAX_POWER)) {
 				controlling_element = -1 * ENGINE_MAX_POWER;
+				g_ilc.saturated = 1;
 				/* Anti windup */
 				e_sum = e_sum - e;
 				/* Check blocking engine */
@@ -186,6 +276,114 @@ void taskScanner(void* pvParameters) {
 }
 
 
+/**
+ * \brief	Enable or disable the speed ripple feed-forward. The learning
+ * 			continues, so the ripple is also reported if it is disabled.
+ * \param[in]	enable is TRUE to apply the learned feed-forward.
+ */
+void taskScannerSetIlc(uint8_t enable) {
+	g_ilcEnable = enable;
+}
+
+/**
+ * \brief	Gets the speed variation within a turn. It is the difference
+ * 			between the fastest and the slowest angle bin relative to the
+ * 			mean speed.
+ * \param[out]	initial is the speed variation of the first turn after the
+ * 				last speed change. [tenth percent]
+ * \param[out]	current is the speed variation of the last turn. [tenth percent]
+ */
+void taskScannerGetRipple(uint16_t *initial, uint16_t *current) {
+	*initial = g_rippleInitial;
+	*current = g_rippleCurrent;
+}
+
+/**
+ * \brief	Resets the feed-forward table and the measurement of the current turn.
+ * \param[in,out]	ilc is the learning control to reset.
+ */
+void ilcReset(ilc_t *ilc) {
+	uint32_t i;
+
+	for (i=0; i<ENGINE_ILC_BINS; i++) {
+		ilc->feed_forward[i] = 0;
+		ilc->error_sum[i] = 0;
+		ilc->speed_sum[i] = 0;
+		ilc->samples[i] = 0;
+	}
+	ilc->saturated = 1;
+	ilc->learned_turns = 0;
+}
+
+/**
+ * \brief	Learns the speed error of the completed turn into the feed-forward
+ * 			table and measures the speed variation. Turns with a saturated
+ * 			controller or with missing bins are not learned.
+ * \param[in,out]	ilc is the learning control.
+ * \return	Speed variation of the completed turn. [tenth percent]
+ */
+uint16_t ilcTurnCompleted(ilc_t *ilc) {
+	uint32_t i;
+	uint8_t complete = 1;
+	int32_t speed, speed_min = INT32_MAX, speed_max = 0, speed_mean = 0;
+	int32_t correction;
+	uint16_t ripple = 0;
+
+	/* Mean speed of each bin [1/16 increments/ms] */
+	for (i=0; i<ENGINE_ILC_BINS; i++) {
+		if (ilc->samples[i] == 0) {
+			complete = 0;
+			break;
+		}
+		speed = 16 * ilc->speed_sum[i] / ilc->samples[i];
+		speed_mean += speed;
+		if (speed < speed_min) {
+			speed_min = speed;
+		}
+		if (speed > speed_max) {
+			speed_max = speed;
+		}
+	}
+
+	if (complete) {
+		/* Speed variation of this turn */
+		speed_mean /= ENGINE_ILC_BINS;
+		if (speed_mean > 0) {
+			ripple = 1000 * (speed_max - speed_min) / speed_mean;
+		}
+
+		/* Learn the table only from an unsaturated turn */
+		if (!ilc->saturated) {
+			for (i=0; i<ENGINE_ILC_BINS; i++) {
+				correction = ENGINE_ILC_GAIN * ilc->error_sum[i] / ilc->samples[i];
+				correction += ilc->feed_forward[i];
+				if (correction > ENGINE_ILC_LIMIT) {
+					correction = ENGINE_ILC_LIMIT;
+				}
+				else if (correction < -ENGINE_ILC_LIMIT) {
+					correction = -ENGINE_ILC_LIMIT;
+				}
+				ilc->feed_forward[i] = correction;
+			}
+		}
+
+		if (ilc->learned_turns < UINT8_MAX) {
+			ilc->learned_turns++;
+		}
+	}
+
+	/* Starts the measurement of the next turn */
+	for (i=0; i<ENGINE_ILC_BINS; i++) {
+		ilc->error_sum[i] = 0;
+		ilc->speed_sum[i] = 0;
+		ilc->samples[i] = 0;
+	}
+	ilc->saturated = 0;
+
+	return ripple;
+}
+
+
 /**
  * @}
  */
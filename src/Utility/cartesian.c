@@ -0,0 +1,69 @@
+/**
+ * \file		cartesian.c
+ * \brief		Cartesian coordinates of the polar points.
+ * \date		2026-10-18
+ * \version		0.1
+ *
+ * \addtogroup	utility
+ * @{
+ */
+
+#include <stdint.h>
+#include <math.h>
+
+#include "cartesian.h"
+
+#ifndef M_PI
+#define M_PI		3.14159265358979323846
+#endif
+
+
+/*
+ * ----------------------------------------------------------------------------
+ * Implementation
+ * ----------------------------------------------------------------------------
+ */
+
+/**
+ * \brief	Calculates the sine and cosine tables of the increments. The
+ * 			azimuth of each increment is the same as increments2tenthdegree(),
+ * 			turned by the rotation of the sensor.
+ * \param[out]	cos_table is the cosine of each increment, inc_per_turn+1 entries. [Q15]
+ * \param[out]	sin_table is the sine of each increment, inc_per_turn+1 entries. [Q15]
+ * \param[in]	inc_per_turn is the number of increments each turn.
+ * \param[in]	rotation is the azimuth of the sensor front. [tenth degree]
+ */
+void cartesianTable(int16_t *cos_table, int16_t *sin_table, uint32_t inc_per_turn, int16_t rotation) {
+	uint32_t i;
+	double angle;
+	int32_t value;
+
+	for (i=0; i<=inc_per_turn; i++) {
+		angle = (3600.0 / inc_per_turn * i - 1800 + rotation) * M_PI / 1800.0;
+
+		/* +1.0 is saturated to the largest Q15 value */
+		value = round(cos(angle) * 32768.0);
+		cos_table[i] = (value > INT16_MAX) ? INT16_MAX : value;
+
+		value = round(sin(angle) * 32768.0);
+		sin_table[i] = (value > INT16_MAX) ? INT16_MAX : value;
+	}
+}
+
+/**
+ * \brief	Rotates a polar point over the tables into Cartesian coordinates.
+ * \param[in]	cos_table is the cosine table of cartesianTable(). [Q15]
+ * \param[in]	sin_table is the sine table of cartesianTable(). [Q15]
+ * \param[in]	distance is the 12 bit distance of the point. [mm]
+ * \param[in]	increments is the azimuth of the point.
+ * \param[out]	x is the coordinate in front direction, rounded. [mm]
+ * \param[out]	y is the coordinate in left direction, rounded. [mm]
+ */
+void cartesianRotate(const int16_t *cos_table, const int16_t *sin_table, uint16_t distance, uint32_t increments, int32_t *x, int32_t *y) {
+	*x = ((int32_t) distance * cos_table[increments] + 0x4000) >> 15;
+	*y = ((int32_t) distance * sin_table[increments] + 0x4000) >> 15;
+}
+
+/**
+ * @}
+ */
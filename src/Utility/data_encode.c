@@ -15,6 +15,24 @@
 extern int sprintf(char* str, const char *fmt, ...);
 
 
+/*
+ * ----------------------------------------------------------------------------
+ * Private variables
+ * ----------------------------------------------------------------------------
+ */
+
+/**
+ * \brief	Base64 look up table due to performance.
+ */
+static const char look_up_table[] = {
+		'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M',
+		'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z',
+		'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm',
+		'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
+		'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
+};
+
+
 /*
  * ----------------------------------------------------------------------------
  * Implementation
@@ -28,15 +46,6 @@ extern int sprintf(char* str, const char *fmt, ...);
  * \param[out]	base64 is a storage address of 4 bytes for the encoded data. MSB first.
  */
 inline void dataEncode(int16_t azimuth, int16_t distance, char *base64) {
-	/* Look up table due to performance */
-	static const char look_up_table[] = {
-			'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M',
-			'N', 'O', 'P', 'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z',
-			'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm',
-			'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z',
-			'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
-	};
-
 	/* Convert azimuth */
 	base64[0] = look_up_table[(azimuth >> 6) & 0x3F];
 	base64[1] = look_up_table[(azimuth) & 0x3F];
@@ -46,6 +55,54 @@ inline void dataEncode(int16_t azimuth, int16_t distance, char *base64) {
 	base64[3] = look_up_table[(distance) & 0x3F];
 }
 
+/**
+ * \brief	Encode the intensity of a point. It is appended to the azimuth and
+ * 			the distance, with the same base64 encoding algorithms.
+ * \param[in]	intensity is the 12 bit unsigned intensity value.
+ * \param[out]	base64 is a storage address of 2 bytes for the encoded data. MSB first.
+ */
+inline void dataEncodeIntensity(uint16_t intensity, char *base64) {
+	/* Convert intensity */
+	base64[0] = look_up_table[(intensity >> 6) & 0x3F];
+	base64[1] = look_up_table[(intensity) & 0x3F];
+}
+
+/**
+ * \brief	Encode an unsigned value with a given number of base64 digits. Each
+ * 			digit holds 6 bits.
+ * \param[in]	value is the unsigned value. Only the lowest 6*digits bits are encoded.
+ * \param[in]	digits is the number of base64 digits.
+ * \param[out]	base64 is a storage address of digits bytes for the encoded data. MSB first.
+ */
+void dataEncodeValue(uint32_t value, uint8_t digits, char *base64) {
+	while (digits > 0) {
+		digits--;
+		base64[digits] = look_up_table[value & 0x3F];
+		value >>= 6;
+	}
+}
+
+/**
+ * \brief	Encode a signed value with a variable number of base64 digits. The
+ * 			sign is moved into the LSB (zigzag), then each digit holds 5 bits,
+ * 			LSB first. Bit 5 of a digit is set if another digit follows.
+ * \param[in]	value is the signed value.
+ * \param[out]	base64 is a storage address of up to 7 bytes for the encoded data.
+ * \return	Number of encoded digits.
+ */
+uint8_t dataEncodeVarint(int32_t value, char *base64) {
+	uint32_t zigzag = ((uint32_t) value << 1) ^ (uint32_t) (value >> 31);
+	uint8_t digits = 0;
+
+	while (zigzag > 0x1F) {
+		base64[digits++] = look_up_table[0x20 | (zigzag & 0x1F)];
+		zigzag >>= 5;
+	}
+	base64[digits++] = look_up_table[zigzag];
+
+	return digits;
+}
+
 /**
  * \brief	Demonstration Encoder of the data  (only the distance).
  * \param[in]	azimuth is the signed 12 bit azimuth value in tenth degree.
@@ -56,6 +113,28 @@ inline void dataEncodeDEMO(int16_t azimuth, int16_t distance, char *str) {
 	sprintf(str, "%d", distance);
 }
 
+/**
+ * \brief	CRC16 of a string (CCITT polynomial 0x1021, initial value 0xFFFF).
+ * \param[in]	data is the string.
+ * \param[in]	length is the number of characters.
+ * \return	The CRC16.
+ */
+uint16_t dataCrc16(const char *data, uint32_t length) {
+	uint16_t crc = 0xFFFF;
+	uint8_t i;
+
+	while (length > 0) {
+		crc ^= (uint16_t) (uint8_t) *data << 8;
+		for (i=0; i<8; i++) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+		data++;
+		length--;
+	}
+
+	return crc;
+}
+
 /**
  * @}
  */
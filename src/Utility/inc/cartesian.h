@@ -0,0 +1,28 @@
+/**
+ * \file		cartesian.h
+ * \brief		Cartesian coordinates of the polar points.
+ * \date		2026-10-18
+ * \version		0.1
+ *
+ * \addtogroup	utility
+ * @{
+ */
+
+#ifndef CARTESIAN_H_
+#define CARTESIAN_H_
+
+
+/*
+ * ----------------------------------------------------------------------------
+ * Prototypes
+ * ----------------------------------------------------------------------------
+ */
+extern void cartesianTable(int16_t *cos_table, int16_t *sin_table, uint32_t inc_per_turn, int16_t rotation);
+extern void cartesianRotate(const int16_t *cos_table, const int16_t *sin_table, uint16_t distance, uint32_t increments, int32_t *x, int32_t *y);
+
+
+#endif /* CARTESIAN_H_ */
+
+/**
+ * @}
+ */
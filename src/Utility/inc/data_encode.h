@@ -19,6 +19,10 @@
  * ----------------------------------------------------------------------------
  */
 extern inline void dataEncode(int16_t azimuth, int16_t distance, char *base64);
+extern inline void dataEncodeIntensity(uint16_t intensity, char *base64);
+extern void dataEncodeValue(uint32_t value, uint8_t digits, char *base64);
+extern uint8_t dataEncodeVarint(int32_t value, char *base64);
+extern uint16_t dataCrc16(const char *data, uint32_t length);
 
 
 #endif /* DATA_ENCODE_H_ */
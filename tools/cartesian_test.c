@@ -0,0 +1,141 @@
+/**
+ * \file		cartesian_test.c
+ * \brief		Host test of the Cartesian coordinates of the data processing.
+ * \date		2026-10-18
+ * \version		0.1
+ *
+ * Builds the tables with cartesianTable() and rotates each point with
+ * cartesianRotate() of the firmware (src/Utility/cartesian.c). It sweeps all
+ * increments of a turn, the whole 12 bit distance range and the mount
+ * rotations from -180 to 180 degree. Each coordinate is compared with the
+ * exact value in double precision, whose azimuth is calculated independently
+ * of the tables. The error is bounded by the rounding of the coordinate
+ * (0.5 mm) and the rounding of the table entry, which is at most one LSB at
+ * the saturation of +1.0 (4095 / 32768 mm). It prints the largest error and
+ * exits with 1 if the bound is exceeded.
+ *
+ * Build: gcc -std=c99 -O2 -I../src/Utility/inc -o cartesian_test cartesian_test.c ../src/Utility/cartesian.c -lm
+ * Usage: cartesian_test [rotation step in tenth degree, default 50]
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "cartesian.h"
+
+#ifndef M_PI
+#define M_PI				3.14159265358979323846
+#endif
+
+
+/*
+ * ----------------------------------------------------------------------------
+ * Settings of the firmware
+ * ----------------------------------------------------------------------------
+ */
+#define INC_PER_TURN		(2000-1)	/*!< BSP_QUADENC_INC_PER_TURN */
+#define CARTESIAN_TABLE		(INC_PER_TURN+1)	/*!< DP_CARTESIAN_TABLE */
+#define ROTATION_MAX		1800		/*!< Bound of 'set scan mount'. [tenth degree] */
+#define DISTANCE_MAX		0xFFF		/*!< 12 bit distance. [mm] */
+
+#define ERROR_BOUND			(0.5 + DISTANCE_MAX / 32768.0)	/*!< [mm] */
+
+
+/*
+ * ----------------------------------------------------------------------------
+ * Private variables
+ * ----------------------------------------------------------------------------
+ */
+
+/**
+ * \brief	Tables of the current rotation, the same as g_cartesian of the firmware.
+ */
+static int16_t g_cos[CARTESIAN_TABLE];
+static int16_t g_sin[CARTESIAN_TABLE];
+
+
+/*
+ * ----------------------------------------------------------------------------
+ * Implementation
+ * ----------------------------------------------------------------------------
+ */
+
+/**
+ * \brief	Exact azimuth of an increment in the vehicle frame. An increment is
+ * 			a fraction of the turn, which starts at -180 degree.
+ * \return	The azimuth. [rad]
+ */
+static double azimuth(uint32_t increments, int rotation) {
+	return 2.0 * M_PI * ((double) increments / INC_PER_TURN - 0.5) + rotation / 1800.0 * M_PI;
+}
+
+/**
+ * \brief	Sweeps all increments and distances of a rotation.
+ * \return	The largest error of a coordinate. [mm]
+ */
+static double sweep(int rotation) {
+	double max_error = 0.0;
+	double c, s, error;
+	int32_t x, y;
+	uint32_t i, d;
+
+	cartesianTable(g_cos, g_sin, INC_PER_TURN, rotation);
+
+	for (i=0; i<CARTESIAN_TABLE; i++) {
+		c = cos(azimuth(i, rotation));
+		s = sin(azimuth(i, rotation));
+
+		for (d=0; d<=DISTANCE_MAX; d++) {
+			cartesianRotate(g_cos, g_sin, d, i, &x, &y);
+
+			error = fabs(x - d * c);
+			if (error > max_error) {
+				max_error = error;
+			}
+			error = fabs(y - d * s);
+			if (error > max_error) {
+				max_error = error;
+			}
+		}
+	}
+
+	return max_error;
+}
+
+/**
+ * \brief	Main function.
+ */
+int main(int argc, char *argv[]) {
+	int step = (argc > 1) ? atoi(argv[1]) : 50;
+	int rotation;
+	double error, max_error = 0.0;
+	int max_rotation = 0;
+
+	if (step < 1) {
+		step = 1;
+	}
+
+	/* Both bounds of the rotation are always checked */
+	for (rotation=-ROTATION_MAX; rotation<ROTATION_MAX+step; rotation+=step) {
+		if (rotation > ROTATION_MAX) {
+			rotation = ROTATION_MAX;
+		}
+		error = sweep(rotation);
+		if (error > max_error) {
+			max_error = error;
+			max_rotation = rotation;
+		}
+	}
+
+	printf("max error %.4f mm at rotation %d (bound %.4f mm)\n",
+			max_error, max_rotation, ERROR_BOUND);
+
+	if (max_error > ERROR_BOUND) {
+		printf("FAIL\n");
+		return 1;
+	}
+	printf("OK\n");
+	return 0;
+}
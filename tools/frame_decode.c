@@ -0,0 +1,449 @@
+/**
+ * \file		frame_decode.c
+ * \brief		Host reference decoder of the data stream.
+ * \date		2026-10-18
+ * \version		0.1
+ *
+ * Reads the messages of the LIDAR from stdin and prints each point as
+ * "<azimuth> <distance> [<intensity>]" and each scan start as
+ * "scan <profile> <scan id>" and each point lost by a fault of the
+ * acquisition as "fault <azimuth>". It decodes the single data points ('$'),
+ * the frames ('%') and the delta encoded frames. The delta encoded frames
+ * are reconstructed to the full scan of all bins. Points in Cartesian
+ * coordinates are printed as "xy <x> <y> [<intensity>]", line segments ('&')
+ * as "line <x1> <y1> <x2> <y2> <residual tenth mm> <points>", blobs ('*')
+ * as "blob <left azimuth> <right azimuth> <nearest distance> <points>" and
+ * tracked objects ('^') as "object <id> <x> <y> <vx> <vy> <extent>". The
+ * frames of the burst capture ('~') and the delta encoded frames are checked
+ * with their CRC, a corrupted frame is printed as "crc error". A delta encoded
+ * frame is also checked against its number of points, a mismatch is printed
+ * as "frame error". After an error of a delta encoded frame the reference is
+ * invalid, so the delta encoded frames are skipped until the next keyframe.
+ *
+ * Build: gcc -std=c99 -O2 -o frame_decode frame_decode.c -lm
+ * Usage: frame_decode [-c] < capture.txt
+ *        -c if the single data points are in Cartesian coordinates
+ *        ('set comm cartesian on'). Frames are marked by the firmware.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+
+/*
+ * ----------------------------------------------------------------------------
+ * Settings of the firmware
+ * ----------------------------------------------------------------------------
+ */
+#define INC_PER_TURN		(2000-1)	/*!< BSP_QUADENC_INC_PER_TURN */
+#define AZIMUTH_SCAN		-2048		/*!< DP_AZIMUTH_SCAN */
+#define AZIMUTH_KEYFRAME	-2047		/*!< DP_AZIMUTH_KEYFRAME */
+#define AZIMUTH_DELTA		-2046		/*!< DP_AZIMUTH_DELTA */
+#define AZIMUTH_CARTESIAN	-2045		/*!< DP_AZIMUTH_CARTESIAN */
+#define AZIMUTH_FAULT		-2044		/*!< DP_AZIMUTH_FAULT */
+#define CARTESIAN_DIGITS	3			/*!< DP_CARTESIAN_DIGITS */
+#define HEADER_LENGTH		14			/*!< DP_FRAME_HEADER_LENGTH */
+#define LINES_HEADER_LENGTH	6			/*!< DP_LINES_HEADER_LENGTH */
+#define LINE_LENGTH			16			/*!< DP_LINE_LENGTH */
+#define OBJECTS_HEADER_LENGTH	6		/*!< DP_OBJECTS_HEADER_LENGTH */
+#define OBJECT_LENGTH		16			/*!< DP_OBJECT_LENGTH */
+#define CAPTURE_CRC_DIGITS	3			/*!< DP_CAPTURE_CRC_DIGITS */
+#define DELTA_BIN_INC		2			/*!< DP_DELTA_BIN_INC */
+#define DELTA_BINS			((INC_PER_TURN+1) / DELTA_BIN_INC)	/*!< DP_DELTA_BINS */
+#define DELTA_BITMAP_LENGTH	((DELTA_BINS + 5) / 6)	/*!< DP_DELTA_BITMAP_LENGTH */
+#define DELTA_EMPTY			INT16_MIN	/*!< DP_DELTA_EMPTY */
+#define DELTA_CRC_DIGITS	3			/*!< DP_DELTA_CRC_DIGITS */
+
+#define MESSAGE_LENGTH		8192		/*!< Longest message. */
+
+
+/*
+ * ----------------------------------------------------------------------------
+ * Private variables
+ * ----------------------------------------------------------------------------
+ */
+
+/**
+ * \brief	Distance of each bin, the same state as the reference of the firmware.
+ */
+static int16_t g_reference[DELTA_BINS];
+
+/**
+ * \brief	TRUE after the first keyframe, FALSE after a corrupted delta
+ * 			encoded frame.
+ */
+static int g_synchronized;
+
+/**
+ * \brief	TRUE if the single data points are in Cartesian coordinates.
+ */
+static int g_cartesian;
+
+
+/*
+ * ----------------------------------------------------------------------------
+ * Implementation
+ * ----------------------------------------------------------------------------
+ */
+
+/**
+ * \brief	Decode a base64 digit.
+ * \param[in]	c is the digit.
+ * \return	The 6 bit value, or -1 if it is not a digit.
+ */
+static int decodeDigit(char c) {
+	if (c >= 'A' && c <= 'Z') return c - 'A';
+	if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+	if (c >= '0' && c <= '9') return c - '0' + 52;
+	if (c == '+') return 62;
+	if (c == '/') return 63;
+	return -1;
+}
+
+/**
+ * \brief	Decode an unsigned value of a given number of digits, MSB first.
+ */
+static uint32_t decodeValue(const char *base64, int digits) {
+	uint32_t value = 0;
+	int i;
+
+	for (i=0; i<digits; i++) {
+		value = (value << 6) | (decodeDigit(base64[i]) & 0x3F);
+	}
+	return value;
+}
+
+/**
+ * \brief	Decode a signed 12 bit value of two digits.
+ */
+static int16_t decodeSigned12(const char *base64) {
+	int16_t value = decodeValue(base64, 2);
+	return (value & 0x800) ? value - 0x1000 : value;
+}
+
+/**
+ * \brief	Decode a signed Cartesian coordinate.
+ */
+static int32_t decodeCoordinate(const char *base64) {
+	int32_t value = decodeValue(base64, CARTESIAN_DIGITS);
+	int32_t sign = 1 << (6 * CARTESIAN_DIGITS - 1);
+	return (value & sign) ? value - 2 * sign : value;
+}
+
+/**
+ * \brief	CRC16 of a string, the same as dataCrc16().
+ */
+static uint16_t crc16(const char *data, size_t length) {
+	uint16_t crc = 0xFFFF;
+	int i;
+
+	while (length > 0) {
+		crc ^= (uint16_t) (uint8_t) *data << 8;
+		for (i=0; i<8; i++) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+		data++;
+		length--;
+	}
+	return crc;
+}
+
+/**
+ * \brief	Decode a variable length value (zigzag, 5 bits each digit, LSB first).
+ * \param[in,out]	base64 is the address of the string pointer. It is moved
+ * 					behind the value.
+ * \param[in]	end is the end of the string, a value is not read beyond it.
+ */
+static int32_t decodeVarint(const char **base64, const char *end) {
+	uint32_t zigzag = 0;
+	int shift = 0;
+	int digit;
+
+	do {
+		digit = decodeDigit(**base64) & 0x3F;
+		(*base64)++;
+		zigzag |= (uint32_t) (digit & 0x1F) << shift;
+		shift += 5;
+	} while ((digit & 0x20) && *base64 < end);
+
+	return (int32_t) (zigzag >> 1) ^ -(int32_t) (zigzag & 1);
+}
+
+/**
+ * \brief	Azimuth of a bin of the delta encoding, the same conversion as
+ * 			increments2tenthdegree().
+ */
+static int16_t binAzimuth(uint32_t bin) {
+	return round(3600.0 / INC_PER_TURN * (bin * DELTA_BIN_INC) - 1800);
+}
+
+/**
+ * \brief	Print the start of a scan or a lost point, if it is a marker.
+ */
+static int printMarker(int16_t azimuth, int16_t distance) {
+	if (azimuth == AZIMUTH_SCAN) {
+		printf("scan %d %d\n", (distance >> 8) & 0x0F, distance & 0xFF);
+		return 1;
+	}
+	if (azimuth == AZIMUTH_FAULT) {
+		printf("fault %d\n", distance);
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * \brief	Decode a single data point.
+ */
+static void decodePoint(const char *msg, size_t length) {
+	int16_t azimuth, distance;
+
+	if (length != 4 && length != 6) {
+		return;
+	}
+	azimuth = decodeSigned12(msg);
+	distance = decodeSigned12(&msg[2]);
+	if (!printMarker(azimuth, distance)) {
+		if (length == 6) {
+			printf("%d %d %u\n", azimuth, distance, (unsigned int) decodeValue(&msg[4], 2));
+		}
+		else {
+			printf("%d %d\n", azimuth, distance);
+		}
+	}
+}
+
+/**
+ * \brief	Decode a single data point in Cartesian coordinates. The scan
+ * 			marker has the length of a polar point.
+ */
+static void decodeCartesian(const char *msg, size_t length) {
+	if (length == 4) {
+		printMarker(decodeSigned12(msg), decodeSigned12(&msg[2]));
+	}
+	else if (length == 2 * CARTESIAN_DIGITS + 2) {
+		printf("xy %d %d %u\n", (int) decodeCoordinate(msg), (int) decodeCoordinate(&msg[CARTESIAN_DIGITS]),
+				(unsigned int) decodeValue(&msg[2 * CARTESIAN_DIGITS], 2));
+	}
+	else if (length == 2 * CARTESIAN_DIGITS) {
+		printf("xy %d %d\n", (int) decodeCoordinate(msg), (int) decodeCoordinate(&msg[CARTESIAN_DIGITS]));
+	}
+}
+
+/**
+ * \brief	Decode a frame, or a delta encoded frame.
+ */
+static void decodeFrame(const char *msg, size_t length) {
+	static int16_t reference[DELTA_BINS];
+	int16_t azimuth, distance;
+	uint32_t points, bin, width, i;
+	const char *ptr, *end;
+
+	if (length < HEADER_LENGTH) {
+		return;
+	}
+	azimuth = decodeSigned12(msg);
+	distance = decodeSigned12(&msg[2]);
+	points = decodeValue(&msg[4], 2);
+
+	if (azimuth == AZIMUTH_KEYFRAME || azimuth == AZIMUTH_DELTA) {
+		/* The whole delta encoded frame is checked before its reference is used */
+		if (length < HEADER_LENGTH + DELTA_BITMAP_LENGTH + DELTA_CRC_DIGITS
+				|| crc16(msg, length - DELTA_CRC_DIGITS)
+				!= decodeValue(&msg[length - DELTA_CRC_DIGITS], DELTA_CRC_DIGITS)) {
+			g_synchronized = 0;
+			printf("crc error\n");
+			return;
+		}
+		length -= DELTA_CRC_DIGITS;
+	}
+	printf("scan %d %d\n", (distance >> 8) & 0x0F, distance & 0xFF);
+
+	if (azimuth == AZIMUTH_SCAN) {
+		/* All points of the scan, with or without the intensity */
+		if (points == 0) {
+			return;
+		}
+		width = (length - HEADER_LENGTH) / points;
+		for (i=0; i<points; i++) {
+			decodePoint(&msg[HEADER_LENGTH + i * width], width);
+		}
+		return;
+	}
+
+	if (azimuth == AZIMUTH_CARTESIAN) {
+		/* All points of the scan in Cartesian coordinates */
+		if (points == 0) {
+			return;
+		}
+		width = (length - HEADER_LENGTH) / points;
+		for (i=0; i<points; i++) {
+			decodeCartesian(&msg[HEADER_LENGTH + i * width], width);
+		}
+		return;
+	}
+
+	if (azimuth != AZIMUTH_KEYFRAME && azimuth != AZIMUTH_DELTA) {
+		return;
+	}
+
+	/* A keyframe clears the reference */
+	if (azimuth == AZIMUTH_KEYFRAME) {
+		for (bin=0; bin<DELTA_BINS; bin++) {
+			reference[bin] = DELTA_EMPTY;
+		}
+	}
+	else if (g_synchronized) {
+		memcpy(reference, g_reference, sizeof(reference));
+	}
+	else {
+		return;
+	}
+
+	/* Apply the differences of the sent bins to a copy of the reference */
+	ptr = &msg[HEADER_LENGTH + DELTA_BITMAP_LENGTH];
+	end = &msg[length];
+	i = 0;
+	for (bin=0; bin<DELTA_BINS && ptr<end; bin++) {
+		if (decodeDigit(msg[HEADER_LENGTH + bin / 6]) & (0x20 >> (bin % 6))) {
+			if (reference[bin] == DELTA_EMPTY) {
+				reference[bin] = 0;
+			}
+			reference[bin] += decodeVarint(&ptr, end);
+			i++;
+		}
+	}
+
+	/* Each sent bin has exactly one difference, or the frame is truncated */
+	for (; bin<DELTA_BINS; bin++) {
+		if (decodeDigit(msg[HEADER_LENGTH + bin / 6]) & (0x20 >> (bin % 6))) {
+			i++;
+		}
+	}
+	if (i != points || ptr != end) {
+		g_synchronized = 0;
+		printf("frame error\n");
+		return;
+	}
+	memcpy(g_reference, reference, sizeof(g_reference));
+	g_synchronized = 1;
+
+	/* Full scan */
+	for (bin=0; bin<DELTA_BINS; bin++) {
+		if (g_reference[bin] != DELTA_EMPTY) {
+			printf("%d %d\n", binAzimuth(bin), g_reference[bin]);
+		}
+	}
+}
+
+/**
+ * \brief	Decode the line segments of a scan.
+ */
+static void decodeLines(const char *msg, size_t length) {
+	uint32_t lines, i;
+	const char *ptr;
+
+	if (length < LINES_HEADER_LENGTH) {
+		return;
+	}
+	printMarker(decodeSigned12(msg), decodeSigned12(&msg[2]));
+	lines = decodeValue(&msg[4], 2);
+	if (length < LINES_HEADER_LENGTH + lines * LINE_LENGTH) {
+		return;
+	}
+
+	for (i=0; i<lines; i++) {
+		ptr = &msg[LINES_HEADER_LENGTH + i * LINE_LENGTH];
+		printf("line %d %d %d %d %u %u\n", (int) decodeCoordinate(&ptr[0]), (int) decodeCoordinate(&ptr[3]),
+				(int) decodeCoordinate(&ptr[6]), (int) decodeCoordinate(&ptr[9]),
+				(unsigned int) decodeValue(&ptr[12], 2), (unsigned int) decodeValue(&ptr[14], 2));
+	}
+}
+
+/**
+ * \brief	Decode the tracked objects of a scan.
+ */
+static void decodeObjects(const char *msg, size_t length) {
+	uint32_t objects, i;
+	const char *ptr;
+
+	if (length < OBJECTS_HEADER_LENGTH) {
+		return;
+	}
+	printMarker(decodeSigned12(msg), decodeSigned12(&msg[2]));
+	objects = decodeValue(&msg[4], 2);
+	if (length < OBJECTS_HEADER_LENGTH + objects * OBJECT_LENGTH) {
+		return;
+	}
+
+	for (i=0; i<objects; i++) {
+		ptr = &msg[OBJECTS_HEADER_LENGTH + i * OBJECT_LENGTH];
+		printf("object %u %d %d %d %d %u\n", (unsigned int) decodeValue(&ptr[0], 2),
+				(int) decodeCoordinate(&ptr[2]), (int) decodeCoordinate(&ptr[5]),
+				(int) decodeCoordinate(&ptr[8]), (int) decodeCoordinate(&ptr[11]),
+				(unsigned int) decodeValue(&ptr[14], 2));
+	}
+}
+
+/**
+ * \brief	Reads the messages from stdin.
+ */
+int main(int argc, char *argv[]) {
+	static char line[MESSAGE_LENGTH];
+	size_t length;
+
+	g_cartesian = (argc > 1 && strcmp(argv[1], "-c") == 0);
+
+	while (fgets(line, sizeof(line), stdin) != NULL) {
+		length = strcspn(line, "\r\n");
+		line[length] = '\0';
+		if (length == 0) {
+			continue;
+		}
+
+		switch (line[0]) {
+		case '$':
+			if (g_cartesian) {
+				decodeCartesian(&line[1], length - 1);
+			}
+			else {
+				decodePoint(&line[1], length - 1);
+			}
+			break;
+
+		case '%':
+			decodeFrame(&line[1], length - 1);
+			break;
+
+		case '&':
+			decodeLines(&line[1], length - 1);
+			break;
+
+		case '~':
+			/* A captured frame, followed by its CRC */
+			if (length - 1 > CAPTURE_CRC_DIGITS && crc16(&line[1], length - 1 - CAPTURE_CRC_DIGITS)
+					== decodeValue(&line[length - CAPTURE_CRC_DIGITS], CAPTURE_CRC_DIGITS)) {
+				decodeFrame(&line[1], length - 1 - CAPTURE_CRC_DIGITS);
+			}
+			else {
+				printf("crc error\n");
+			}
+			break;
+
+		case '^':
+			decodeObjects(&line[1], length - 1);
+			break;
+
+		case '*':
+			if (length - 1 == 8) {
+				printf("blob %d %d %d %d\n", decodeSigned12(&line[1]), decodeSigned12(&line[3]),
+						decodeSigned12(&line[5]), (int) decodeValue(&line[7], 2));
+			}
+			break;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,142 @@
+/**
+ * \file		raw_record.c
+ * \brief		Host recorder of the raw TDC data.
+ * \date		2026-10-18
+ * \version		0.1
+ *
+ * Reads the messages of the LIDAR from stdin ('set comm raw on', then
+ * 'data') and writes each raw record ('!') as one CSV line to stdout:
+ * "sequence,profile,scan,increments,calibrate,pulse_width,expected,hits,
+ * cal_resonator,temperature,cycles,hit1,hit2,...". The records with a CRC
+ * error and the records dropped by the firmware are counted on stderr.
+ *
+ * Build: gcc -std=c99 -O2 -o raw_record raw_record.c
+ * Usage: stty -F /dev/ttyUSB0 115200 raw && raw_record < /dev/ttyUSB0 > raw.csv
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+
+/*
+ * ----------------------------------------------------------------------------
+ * Settings of the firmware
+ * ----------------------------------------------------------------------------
+ */
+#define HEADER_LENGTH		28			/*!< DP_RAW_HEADER_LENGTH */
+#define HIT_DIGITS			6			/*!< DP_RAW_HIT_DIGITS */
+#define CRC_DIGITS			3			/*!< DP_CAPTURE_CRC_DIGITS */
+#define SEQUENCE_MASK		0xFFF		/*!< The sequence has 2 digits. */
+
+#define MESSAGE_LENGTH		1024		/*!< Longest message. */
+
+
+/*
+ * ----------------------------------------------------------------------------
+ * Implementation
+ * ----------------------------------------------------------------------------
+ */
+
+/**
+ * \brief	Decode a base64 digit.
+ * \param[in]	c is the digit.
+ * \return	The 6 bit value, or -1 if it is not a digit.
+ */
+static int decodeDigit(char c) {
+	if (c >= 'A' && c <= 'Z') return c - 'A';
+	if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+	if (c >= '0' && c <= '9') return c - '0' + 52;
+	if (c == '+') return 62;
+	if (c == '/') return 63;
+	return -1;
+}
+
+/**
+ * \brief	Decode an unsigned value of a given number of digits, MSB first.
+ */
+static uint32_t decodeValue(const char *base64, int digits) {
+	uint32_t value = 0;
+	int i;
+
+	for (i=0; i<digits; i++) {
+		value = (value << 6) | (decodeDigit(base64[i]) & 0x3F);
+	}
+	return value;
+}
+
+/**
+ * \brief	CRC16 of a string, the same as dataCrc16().
+ */
+static uint16_t crc16(const char *data, size_t length) {
+	uint16_t crc = 0xFFFF;
+	int i;
+
+	while (length > 0) {
+		crc ^= (uint16_t) (uint8_t) *data << 8;
+		for (i=0; i<8; i++) {
+			crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+		}
+		data++;
+		length--;
+	}
+	return crc;
+}
+
+/**
+ * \brief	Reads the messages from stdin.
+ */
+int main(void) {
+	static char line[MESSAGE_LENGTH];
+	const char *msg;
+	size_t length;
+	uint32_t sequence, last = 0, hits, flags, i;
+	unsigned long records = 0, errors = 0, dropped = 0;
+	int synchronized = 0;
+
+	while (fgets(line, sizeof(line), stdin) != NULL) {
+		length = strcspn(line, "\r\n");
+		line[length] = '\0';
+		if (length == 0 || line[0] != '!') {
+			continue;
+		}
+		msg = &line[1];
+		length--;
+
+		/* Length and CRC of the record */
+		if (length < HEADER_LENGTH + CRC_DIGITS) {
+			errors++;
+			continue;
+		}
+		hits = decodeValue(&msg[9], 1);
+		if (length != HEADER_LENGTH + hits * HIT_DIGITS + CRC_DIGITS
+				|| crc16(msg, length - CRC_DIGITS) != decodeValue(&msg[length - CRC_DIGITS], CRC_DIGITS)) {
+			errors++;
+			continue;
+		}
+
+		/* Gaps of the sequence are the dropped records */
+		sequence = decodeValue(&msg[0], 2);
+		if (synchronized) {
+			dropped += (sequence - last - 1) & SEQUENCE_MASK;
+		}
+		last = sequence;
+		synchronized = 1;
+		records++;
+
+		flags = decodeValue(&msg[6], 2);
+		printf("%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u", (unsigned int) sequence,
+				(unsigned int) (decodeValue(&msg[4], 2) >> 8), (unsigned int) (decodeValue(&msg[4], 2) & 0xFF),
+				(unsigned int) decodeValue(&msg[2], 2), (unsigned int) ((flags >> 8) & 1), (unsigned int) (flags & 0xFF),
+				(unsigned int) decodeValue(&msg[8], 1), (unsigned int) hits,
+				(unsigned int) decodeValue(&msg[10], 6), (unsigned int) decodeValue(&msg[16], 6),
+				(unsigned int) decodeValue(&msg[22], 6));
+		for (i=0; i<hits; i++) {
+			printf(",%u", (unsigned int) decodeValue(&msg[HEADER_LENGTH + i * HIT_DIGITS], HIT_DIGITS));
+		}
+		printf("\n");
+	}
+
+	fprintf(stderr, "%lu records, %lu dropped, %lu crc errors\n", records, dropped, errors);
+	return 0;
+}